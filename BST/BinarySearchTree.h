@@ -1,19 +1,143 @@
 #pragma once
 
+#include <algorithm> // std::max
 #include <functional> // std::less
 #include <iostream>
+#include <iterator>
+#include <memory> // std::unique_ptr
+#include <new>
 #include <queue> // std::queue
+#include <type_traits>
 #include <utility> // std::pair
+#include <vector>
 
 using std::queue;
 
-template <typename K, typename V, typename Comparator = std::less<K>>
+// Balancing policies for BinarySearchTree. A policy adds its bookkeeping to every node (node_data) and
+// gets to restructure a subtree after one of its children changed (rebalance) or to recompute the bookkeeping
+// of a node from its children (update). Rotations must keep the parent pointers, which the iterators walk, in
+// step. Policies with balances == false are never called, so the plain tree pays nothing for them.
+
+// Plain binary search tree: no bookkeeping, never restructures.
+struct NoBalancing {
+    struct node_data {};
+
+    static constexpr bool balances = false;
+
+    template <typename Node>
+    static void update(Node*) {}
+
+    template <typename Node>
+    static void rebalance(Node*&) {}
+};
+
+// AVL tree: every node records its height, and rotations keep the heights of sibling subtrees within one
+// of each other, so the tree height stays below 1.44 log2(n) whatever the insertion order.
+struct AVLBalancing {
+    struct node_data {
+        int height = 1;
+    };
+
+    static constexpr bool balances = true;
+
+    template <typename Node>
+    static void update(Node* node) { update_height(node); }
+
+    template <typename Node>
+    static int height(const Node* node) { return (node == nullptr) ? 0 : node->height; }
+
+    template <typename Node>
+    static void update_height(Node* node) { node->height = 1 + std::max(height(node->left), height(node->right)); }
+
+    template <typename Node>
+    static void rotate_right(Node*& node) {
+        Node* pivot = node->left;
+        node->left = pivot->right;
+        if (node->left != nullptr) { node->left->parent = node; }
+        pivot->right = node;
+        pivot->parent = node->parent;
+        node->parent = pivot;
+        update_height(node);
+        update_height(pivot);
+        node = pivot;
+    }
+
+    template <typename Node>
+    static void rotate_left(Node*& node) {
+        Node* pivot = node->right;
+        node->right = pivot->left;
+        if (node->right != nullptr) { node->right->parent = node; }
+        pivot->left = node;
+        pivot->parent = node->parent;
+        node->parent = pivot;
+        update_height(node);
+        update_height(pivot);
+        node = pivot;
+    }
+
+    template <typename Node>
+    static void rebalance(Node*& node) {
+        if (node == nullptr) { return; }
+
+        int balance = height(node->left) - height(node->right);
+
+        if (balance > 1) {
+            if (height(node->left->left) < height(node->left->right)) { rotate_left(node->left); }
+            rotate_right(node);
+        }
+        else if (balance < -1) {
+            if (height(node->right->right) < height(node->right->left)) { rotate_right(node->right); }
+            rotate_left(node);
+        }
+        else {
+            update_height(node);
+        }
+    }
+};
+
+// Order-statistic augmentation on top of another policy: every node also records the size of its subtree,
+// which lets the tree answer select, rank and count_range in O(height). Use it over AVLBalancing to keep
+// those queries O(log n).
+template <typename BasePolicy = NoBalancing>
+struct OrderStatistics {
+    struct node_data : BasePolicy::node_data {
+        size_t subtree_size = 1;
+    };
+
+    static constexpr bool balances = true;
+
+    template <typename Node>
+    static size_t subtree_size(const Node* node) { return (node == nullptr) ? 0 : node->subtree_size; }
+
+    template <typename Node>
+    static void update_size(Node* node) { node->subtree_size = 1 + subtree_size(node->left) + subtree_size(node->right); }
+
+    template <typename Node>
+    static void update(Node* node) {
+        BasePolicy::update(node);
+        update_size(node);
+    }
+
+    template <typename Node>
+    static void rebalance(Node*& node) {
+        if (node == nullptr) { return; }
+
+        BasePolicy::rebalance(node);
+
+        // rotations only rearrange the new subtree root and its two children
+        if (node->left != nullptr) { update_size(node->left); }
+        if (node->right != nullptr) { update_size(node->right); }
+        update_size(node);
+    }
+};
+
+template <typename K, typename V, typename Comparator = std::less<K>, typename BalancingPolicy = NoBalancing>
 class BinarySearchTree {
 
     public:
         using key_type        = K;
         using value_type      = V;
-        using pair            = std::pair<key_type, value_type>;
+        using pair            = std::pair<const key_type, value_type>;
         using pointer         = pair*;
         using const_pointer   = const pair*;
         using reference       = pair&;
@@ -23,39 +147,158 @@ class BinarySearchTree {
   
 
     private:
-        struct BinaryNode {
+        struct BinaryNode : BalancingPolicy::node_data {
             pair element;
             BinaryNode* left;
             BinaryNode* right;
+            BinaryNode* parent;
          
-            BinaryNode(const pair & x, BinaryNode *lt, BinaryNode *rt) : element{x}, left{lt}, right{rt} {}
+            BinaryNode(const pair & x, BinaryNode *lt, BinaryNode *rt, BinaryNode *pt = nullptr)
+                : element{x}, left{lt}, right{rt}, parent{pt} {}
             
-            BinaryNode(pair && x, BinaryNode *lt, BinaryNode *rt) : element{std::move(x)}, left{lt}, right{rt} {}
+            BinaryNode(pair && x, BinaryNode *lt, BinaryNode *rt, BinaryNode *pt = nullptr)
+                : element{std::move(x)}, left{lt}, right{rt}, parent{pt} {}
         };
 
     public:
         using Node = BinaryNode;
 
     private:
+        // whether the policy keeps subtree sizes (OrderStatistics), which select, rank and count_range need
+        static constexpr bool has_order_statistics = requires { &BalancingPolicy::node_data::subtree_size; };
+
+    // in-order iterator; end() is a null node, and the tree pointer lets --end() find the maximum
+    template <typename pointer_type, typename reference_type, typename node_pointer>
+    class basic_iterator {
+
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type        = pair;
+            using difference_type   = ptrdiff_t;
+            using pointer           = pointer_type;
+            using reference         = reference_type;
+
+        private:
+            friend class BinarySearchTree;
+
+            node_pointer node;
+            const BinarySearchTree* tree;
+
+            basic_iterator(node_pointer node, const BinarySearchTree* tree) noexcept : node{node}, tree{tree} {}
+
+        public:
+            basic_iterator() : node{nullptr}, tree{nullptr} {};
+
+            // iterator -> const_iterator
+            operator basic_iterator<const pair*, const pair&, const Node*>() const noexcept {
+                return basic_iterator<const pair*, const pair&, const Node*>(node, tree);
+            }
+
+            reference operator*() const { return node->element; }
+
+            pointer operator->() const { return &(node->element); }
+
+            // Prefix Increment: ++a
+            basic_iterator& operator++() {
+                if (node->right != nullptr) {
+                    node = node->right;
+                    while (node->left != nullptr) { node = node->left; }
+                }
+                else {
+                    // climb until we come up from a left child
+                    node_pointer child = node;
+                    node = node->parent;
+                    while (node != nullptr && child == node->right) { child = node; node = node->parent; }
+                }
+                return *this;
+            }
+
+            // Postfix Increment: a++
+            basic_iterator operator++(int) { basic_iterator result = *this; ++(*this) ; return result; }
+
+            // Prefix Decrement: --a
+            basic_iterator& operator--() {
+                if (node == nullptr) {
+                    node = tree->_root;
+                    while (node->right != nullptr) { node = node->right; }
+                }
+                else if (node->left != nullptr) {
+                    node = node->left;
+                    while (node->right != nullptr) { node = node->right; }
+                }
+                else {
+                    // climb until we come up from a right child
+                    node_pointer child = node;
+                    node = node->parent;
+                    while (node != nullptr && child == node->left) { child = node; node = node->parent; }
+                }
+                return *this;
+            }
+
+            // Postfix Decrement: a--
+            basic_iterator operator--(int) { basic_iterator result = *this; --(*this) ; return result; }
+
+            friend bool operator==(const basic_iterator& lhs, const basic_iterator& rhs) noexcept { return lhs.node == rhs.node; }
+
+            friend bool operator!=(const basic_iterator& lhs, const basic_iterator& rhs) noexcept { return !(lhs == rhs); }
+    };
+
+    // a pair of iterators usable in a range-based for loop
+    template <typename It>
+    struct basic_range {
+        It first;
+        It last;
+
+        It begin() const { return first; }
+        It end() const { return last; }
+    };
+
+    public:
+        using iterator       = basic_iterator<pointer, reference, Node*>;
+        using const_iterator = basic_iterator<const_pointer, const_reference, const Node*>;
+        using range_type       = basic_range<iterator>;
+        using const_range_type = basic_range<const_iterator>;
+
+    private:
+        // Nodes are allocated one at a time, except that clone and build_from_sorted place the whole tree in a
+        // single block. Erased block nodes go on a free list that inserts use before allocating, and the block is
+        // released as soon as none of its nodes is in use, so a tree never holds more than its peak copy size.
+        union Slot {
+            Slot* next_free;
+            Node node;
+
+            Slot() : next_free{nullptr} {}
+            ~Slot() {}
+        };
+
         Node* _root;
         size_type _size;
         Comparator comp;
 
+        std::unique_ptr<Slot[]> block;
+        size_type block_size;
+        size_type block_used;
+        Slot* free_slots;
+
     public:
-        BinarySearchTree() : _root(nullptr), _size(0), comp(Comparator{}) {}
+        BinarySearchTree() : _root(nullptr), _size(0), comp(Comparator{}), block_size(0), block_used(0), free_slots(nullptr) {}
 
         // Copy constructor
-        BinarySearchTree(const BinarySearchTree & rhs) : _root(nullptr), _size(rhs._size), comp(Comparator{}) {
-            _root = clone(rhs._root);
+        BinarySearchTree(const BinarySearchTree & rhs) : BinarySearchTree() {
+            clone(rhs);
         }
 
         void swap(BinarySearchTree & src, BinarySearchTree & dst) {
             std::swap(src._size, dst._size);
             std::swap(src._root, dst._root);
+            std::swap(src.block, dst.block);
+            std::swap(src.block_size, dst.block_size);
+            std::swap(src.block_used, dst.block_used);
+            std::swap(src.free_slots, dst.free_slots);
         }
 
         // Move constructor
-        BinarySearchTree(BinarySearchTree && rhs) : _root(nullptr), _size(rhs._size), comp(Comparator{}) {
+        BinarySearchTree(BinarySearchTree && rhs) : BinarySearchTree() {
             swap(*this, rhs);
         }
 
@@ -63,8 +306,7 @@ class BinarySearchTree {
         BinarySearchTree & operator=(const BinarySearchTree & rhs) {
             if (this != &rhs) {
                 clear(); 
-                _size = rhs._size;
-                _root = clone(rhs._root);
+                clone(rhs);
             }
             return *this;
         }
@@ -73,8 +315,6 @@ class BinarySearchTree {
         BinarySearchTree & operator=(BinarySearchTree && rhs) {
             if (this != &rhs) {
                 clear();
-                _size = 0;
-                _root = nullptr;
                 swap(*this, rhs);
             }
             return *this; 
@@ -92,187 +332,436 @@ class BinarySearchTree {
         const_reference root() const { return _root->element; }
     
 
-        bool contains(const key_type & key) const { return contains(key, _root); }
+        bool contains(const key_type & key) const { return find_node(key) != nullptr; }
 
-        value_type & find(const key_type & key) { return find(key, _root)->element.second; }
+        value_type & find(const key_type & key) { return find_node(key)->element.second; }
 
-        const value_type & find(const key_type & key) const { return find(key, _root)->element.second; }
+        const value_type & find(const key_type & key) const { return find_node(key)->element.second; }
 
 
         bool empty() const { return _size == 0; }
 
         size_type size() const { return _size; }
 
-        void clear() { clear(_root); _size = 0; _root = nullptr; }
+        void clear() {
+            // nothing to do node by node if every node sits in the block and needs no destructor
+            if (!std::is_trivially_destructible<Node>::value || block_used != _size) {
+                // rotate left children up until the node has none, so the tree is dismantled without a stack
+                Node* node = _root;
+                while (node != nullptr) {
+                    if (node->left != nullptr) {
+                        Node* left = node->left;
+                        node->left = left->right;
+                        left->right = node;
+                        node = left;
+                    }
+                    else {
+                        Node* right = node->right;
+                        if (in_block(node)) { node->~Node(); } else { delete node; }
+                        node = right;
+                    }
+                }
+            }
 
+            release_block();
+            _size = 0;
+            _root = nullptr;
+        }
 
-        void insert(const pair & x) { insert(x, _root); }
 
-        void insert(pair && x) { insert(std::move(x), _root); }
+        void insert(const pair & x) { insert_pair(x); }
 
-        void erase(const key_type & key) { erase(key, _root); }
+        void insert(pair && x) { insert_pair(std::move(x)); }
 
+        void erase(const key_type & key) {
+            Node* node = find_node(key);
+            if (node == nullptr) { return; }
 
-    private:
-        const Node* min(const Node* node) const {
-            return (node->left == nullptr) ? node : min(node->left);
-        }
+            // the lowest node whose subtree changed
+            Node* changed;
 
-        const Node* max(const Node* node) const {
-            return (node->right == nullptr) ? node : max(node->right);
-        }
-        
-        void insert(const pair & x, Node*& node) {
-            if (node == nullptr) {
-                node = new Node(x, 0, 0);
-                _size++;
-                return;
-            }
+            if (node->left != nullptr && node->right != nullptr) {
+                // relink the successor (the minimum of the right subtree) into the erased node's place
+                Node* successor = min(node->right);
 
-            if (comp(x.first, node->element.first)) {
-                insert(x, node->left);
-            }
-            else if (comp(node->element.first, x.first)) {
-                insert(x, node->right);
+                if (successor == node->right) {
+                    changed = successor;
+                }
+                else {
+                    changed = successor->parent;
+                    changed->left = successor->right;
+                    if (successor->right != nullptr) { successor->right->parent = changed; }
+                    successor->right = node->right;
+                    successor->right->parent = successor;
+                }
+
+                successor->left = node->left;
+                successor->left->parent = successor;
+                static_cast<typename BalancingPolicy::node_data&>(*successor) = *node;
+                replace(node, successor);
             }
             else {
-                node->element.second = x.second; 
+                changed = node->parent;
+                replace(node, (node->left != nullptr) ? node->left : node->right);
             }
+
+            destroy(node);
+            _size--;
+            rebalance_upwards(changed);
         }
 
-        void insert(pair && x, Node*& node) {
-            if (node == nullptr) {
-                node = new Node(std::move(x), 0, 0);
-                _size++;
-                return;
-            }
+        /**
+         * Replace the contents with the pairs in [first, last), which must be sorted by strictly increasing key.
+         * Builds a perfectly balanced tree in O(n), with all nodes in one block in key order.
+         */
+        template <typename ForwardIt>
+        void build_from_sorted(ForwardIt first, ForwardIt last) {
+            clear();
 
-            if (comp(x.first, node->element.first)) {
-                insert(std::move(x), node->left);
-            }
-            else if (comp(node->element.first, x.first)) {
-                insert(std::move(x), node->right);
+            size_type count = static_cast<size_type>(std::distance(first, last));
+            if (count == 0) { return; }
+
+            Slot* block = allocate_block(count);
+            for (size_type i = 0; i < count; i++, ++first) { new (&block[i].node) Node(*first, nullptr, nullptr); }
+            _size = count;
+
+            // link the middle of every span as the root of that span's subtree
+            struct Span {
+                size_type first;
+                size_type last;
+                Node* parent;
+                Node** link;
+            };
+
+            std::vector<Span> spans;
+            spans.push_back(Span{0, count, nullptr, &_root});
+
+            while (!spans.empty()) {
+                Span span = spans.back();
+                spans.pop_back();
+                if (span.first == span.last) { continue; }
+
+                size_type middle = span.first + (span.last - span.first) / 2;
+                Node* node = &block[middle].node;
+                node->parent = span.parent;
+                *span.link = node;
+
+                spans.push_back(Span{span.first, middle, node, &node->left});
+                spans.push_back(Span{middle + 1, span.last, node, &node->right});
             }
-            else {
-                node->element.second = std::move(x.second); 
+
+            if constexpr (BalancingPolicy::balances) {
+                for_each_postorder([](Node* node) { BalancingPolicy::update(node); });
             }
         }
 
-        void erase(const key_type & key, Node*& node) {
-            if (node == nullptr) { return; }
 
-            if (comp(key, node->element.first)) {
-                return erase(key, node->left);
-            }
-            else if (comp(node->element.first, key)) {
-                return erase(key, node->right);
-            }
-            else {
-                if (node->left == nullptr && node->right == nullptr) {
-                    delete node;
-                    node = nullptr;
-                    _size--;
-                }
-                else if (node->left == nullptr && node->right != nullptr) {
-                    Node* temp = node;
+        iterator begin() { return iterator(_root == nullptr ? nullptr : min(_root), this); }
+
+        const_iterator begin() const { return const_iterator(_root == nullptr ? nullptr : min(_root), this); }
+
+        iterator end() { return iterator(nullptr, this); }
+
+        const_iterator end() const { return const_iterator(nullptr, this); }
+
+        // Return an iterator to the first pair whose key is not less than key, or end()
+        iterator lower_bound(const key_type & key) { return iterator(lower_bound(key, _root), this); }
+
+        const_iterator lower_bound(const key_type & key) const { return const_iterator(lower_bound(key, _root), this); }
+
+        // Return an iterator to the first pair whose key is greater than key, or end()
+        iterator upper_bound(const key_type & key) { return iterator(upper_bound(key, _root), this); }
+
+        const_iterator upper_bound(const key_type & key) const { return const_iterator(upper_bound(key, _root), this); }
+
+        // The pairs with lo <= key < hi, in order; only the matching nodes and two root-to-leaf paths are visited
+        range_type range(const key_type & lo, const key_type & hi) {
+            iterator first = lower_bound(lo);
+            return range_type{first, comp(lo, hi) ? lower_bound(hi) : first};
+        }
+
+        const_range_type range(const key_type & lo, const key_type & hi) const {
+            const_iterator first = lower_bound(lo);
+            return const_range_type{first, comp(lo, hi) ? lower_bound(hi) : first};
+        }
+
+        // Order statistics, available with the OrderStatistics policy
+
+        // Return an iterator to the k-th smallest pair (counting from 0), or end() if k >= size()
+        iterator select(size_type k) requires has_order_statistics { return iterator(select_node(k), this); }
+
+        const_iterator select(size_type k) const requires has_order_statistics { return const_iterator(select_node(k), this); }
+
+        // Return the number of keys less than key
+        size_type rank(const key_type & key) const requires has_order_statistics {
+            size_type result = 0;
+            const Node* node = _root;
+            while (node != nullptr) {
+                if (comp(node->element.first, key)) {
+                    result += BalancingPolicy::subtree_size(node->left) + 1;
                     node = node->right;
-                    delete temp;
-                    _size--;
-                }
-                else if (node->left != nullptr && node->right == nullptr) {
-                    Node* temp = node;
-                    node = node->left;
-                    delete temp;
-                    _size--;
                 }
                 else {
-                    const Node* successor = min(node->right);
-                    node->element = successor->element;
-                    erase(successor->element.first, node->right);
+                    node = node->left;
                 }
             }
+            return result;
         }
 
-        bool contains(const key_type & key, const Node* node) const {
-            if (node == nullptr) { return false; }
+        // Return the number of keys with lo <= key < hi, the size of range(lo, hi)
+        size_type count_range(const key_type & lo, const key_type & hi) const requires has_order_statistics {
+            return comp(lo, hi) ? rank(hi) - rank(lo) : 0;
+        }
 
-            if (comp(key, node->element.first)) {
-                return contains(key, node->left);
-            }
-            else if (comp(node->element.first, key)) {
-                return contains(key, node->right);
+
+    private:
+        static Node* min(Node* node) {
+            while (node->left != nullptr) { node = node->left; }
+            return node;
+        }
+
+        static Node* max(Node* node) {
+            while (node->right != nullptr) { node = node->right; }
+            return node;
+        }
+
+        // a block of count slots, all of them counted as in use; the tree must be empty
+        Slot* allocate_block(size_type count) {
+            block = std::make_unique<Slot[]>(count);
+            block_size = count;
+            block_used = count;
+            return block.get();
+        }
+
+        void release_block() {
+            block.reset();
+            block_size = 0;
+            block_used = 0;
+            free_slots = nullptr;
+        }
+
+        bool in_block(const Node* node) const {
+            const Slot* slot = reinterpret_cast<const Slot*>(node);
+            std::less<const Slot*> before;
+            return block != nullptr && !before(slot, block.get()) && before(slot, block.get() + block_size);
+        }
+
+        template <typename... Args>
+        Node* create(Args&&... args) {
+            if (free_slots == nullptr) { return new Node(std::forward<Args>(args)...); }
+
+            Slot* slot = free_slots;
+            free_slots = slot->next_free;
+            try {
+                new (&slot->node) Node(std::forward<Args>(args)...);
             }
-            else {
-                return true;
+            catch (...) {
+                slot->next_free = free_slots;
+                free_slots = slot;
+                throw;
             }
+            block_used++;
+            return &slot->node;
         }
 
-        Node* find(const key_type & key, Node* node) {
-            if (node == nullptr) { return node; }
+        void destroy(Node* node) {
+            if (!in_block(node)) {
+                delete node;
+                return;
+            }
 
-            if (comp(key, node->element.first)) {
-                return find(key, node->left);
+            node->~Node();
+            if (--block_used == 0) {
+                release_block();
+                return;
             }
-            else if (comp(node->element.first, key)) {
-                return find(key, node->right);
+
+            Slot* slot = reinterpret_cast<Slot*>(node);
+            slot->next_free = free_slots;
+            free_slots = slot;
+        }
+
+        // the child pointer (or _root) that points at node
+        Node*& link_to(Node* node) {
+            if (node->parent == nullptr) { return _root; }
+            return (node->parent->left == node) ? node->parent->left : node->parent->right;
+        }
+
+        // put replacement (possibly null) where node hangs in the tree
+        void replace(Node* node, Node* replacement) {
+            link_to(node) = replacement;
+            if (replacement != nullptr) { replacement->parent = node->parent; }
+        }
+
+        // let the balancing policy restructure every subtree from node up to the root
+        void rebalance_upwards(Node* node) {
+            if constexpr (BalancingPolicy::balances) {
+                while (node != nullptr) {
+                    Node* parent = node->parent;
+                    BalancingPolicy::rebalance(link_to(node));
+                    node = parent;
+                }
             }
-            else {
-                return node;
+        }
+
+        template <typename Function>
+        void for_each_postorder(Function visit) {
+            Node* previous = nullptr;
+            Node* node = _root;
+
+            while (node != nullptr) {
+                if (previous == node->parent && node->left != nullptr) {
+                    previous = node;
+                    node = node->left;
+                }
+                else if (previous != node->right && node->right != nullptr) {
+                    previous = node;
+                    node = node->right;
+                }
+                else {
+                    visit(node);
+                    previous = node;
+                    node = node->parent;
+                }
             }
         }
 
-        const Node* find(const key_type & key, const Node* node) const {
-            if (node == nullptr) { return node; }
+        Node* select_node(size_type k) const {
+            Node* node = _root;
+            while (node != nullptr) {
+                size_type left = BalancingPolicy::subtree_size(node->left);
+                if (k < left) {
+                    node = node->left;
+                }
+                else if (k > left) {
+                    k -= left + 1;
+                    node = node->right;
+                }
+                else {
+                    return node;
+                }
+            }
+            return nullptr;
+        }
 
-            if (comp(key, node->element.first)) {
-                return find(key, node->left);
+        Node* find_node(const key_type & key) const {
+            Node* node = _root;
+            while (node != nullptr) {
+                if (comp(key, node->element.first)) {
+                    node = node->left;
+                }
+                else if (comp(node->element.first, key)) {
+                    node = node->right;
+                }
+                else {
+                    return node;
+                }
             }
-            else if (comp(node->element.first, key)) {
-                return find(key, node->right);
+            return nullptr;
+        }
+
+        // the deepest node on the search path whose key is not less than (lower) or greater than (upper) key
+        Node* lower_bound(const key_type & key, Node* node) const {
+            Node* result = nullptr;
+            while (node != nullptr) {
+                if (comp(node->element.first, key)) { node = node->right; } else { result = node; node = node->left; }
             }
-            else {
-                return node;
+            return result;
+        }
+
+        Node* upper_bound(const key_type & key, Node* node) const {
+            Node* result = nullptr;
+            while (node != nullptr) {
+                if (comp(key, node->element.first)) { result = node; node = node->left; } else { node = node->right; }
             }
+            return result;
         }
 
-        void clear(Node* node) {
-            // base case
-            if (node == nullptr) { return; }
+        template <typename P>
+        void insert_pair(P && x) {
+            Node* parent = nullptr;
+            Node** link = &_root;
 
-            clear(node->left); 
-            clear(node->right);
+            while (*link != nullptr) {
+                parent = *link;
+                if (comp(x.first, parent->element.first)) {
+                    link = &parent->left;
+                }
+                else if (comp(parent->element.first, x.first)) {
+                    link = &parent->right;
+                }
+                else {
+                    parent->element.second = std::forward<P>(x).second;
+                    return;
+                }
+            }
 
-            delete node;      
+            *link = create(std::forward<P>(x), nullptr, nullptr, parent);
+            _size++;
+            rebalance_upwards(parent);
         }
-        
-        Node* clone (const Node* node) const {
-            // base case
-            if (node == nullptr) { return nullptr; }
- 
-            Node* copy = new Node(node->element, 0, 0);
 
-            copy->left = clone(node->left);
-            copy->right = clone(node->right);
+        // copy rhs (this tree must be empty) in preorder into one block, walking both trees in step
+        void clone(const BinarySearchTree & rhs) {
+            if (rhs._root == nullptr) { return; }
+
+            Slot* block = allocate_block(rhs._size);
+            size_type used = 0;
 
-            return copy;
+            auto copy = [&](const Node* node, Node* parent) {
+                Node* result = new (&block[used++].node) Node(node->element, nullptr, nullptr, parent);
+                static_cast<typename BalancingPolicy::node_data&>(*result) = *node;
+                return result;
+            };
+
+            const Node* source = rhs._root;
+            Node* target = copy(source, nullptr);
+            _root = target;
+
+            while (source != nullptr) {
+                if (source->left != nullptr && target->left == nullptr) {
+                    target->left = copy(source->left, target);
+                    source = source->left;
+                    target = target->left;
+                }
+                else if (source->right != nullptr && target->right == nullptr) {
+                    target->right = copy(source->right, target);
+                    source = source->right;
+                    target = target->right;
+                }
+                else {
+                    source = source->parent;
+                    target = target->parent;
+                }
+            }
+
+            _size = rhs._size;
         }
 
     public:
-        template <typename KK, typename VV, typename CC>
-        friend void printLevelByLevel(const BinarySearchTree<KK, VV, CC>& bst, std::ostream & out);
+        template <typename KK, typename VV, typename CC, typename BB>
+        friend void printLevelByLevel(const BinarySearchTree<KK, VV, CC, BB>& bst, std::ostream & out);
 
-        template <typename KK, typename VV, typename CC>
-        friend std::ostream& printNode(std::ostream & o, const typename BinarySearchTree<KK, VV, CC>::Node & node);
+        template <typename KK, typename VV, typename CC, typename BB>
+        friend std::ostream& printNode(std::ostream & o, const typename BinarySearchTree<KK, VV, CC, BB>::Node & node);
 };
 
-template <typename KK, typename VV, typename CC>
-std::ostream& printNode(std::ostream & o, const typename BinarySearchTree<KK, VV, CC>::Node & node) {
+// Self-balancing (AVL) binary search tree with the same interface
+template <typename K, typename V, typename Comparator = std::less<K>>
+using AVLTree = BinarySearchTree<K, V, Comparator, AVLBalancing>;
+
+// AVL tree with subtree sizes: select, rank and count_range in O(log n)
+template <typename K, typename V, typename Comparator = std::less<K>>
+using OrderStatisticTree = BinarySearchTree<K, V, Comparator, OrderStatistics<AVLBalancing>>;
+
+template <typename KK, typename VV, typename CC, typename BB>
+std::ostream& printNode(std::ostream & o, const typename BinarySearchTree<KK, VV, CC, BB>::Node & node) {
     return o << "(" << node.element.first << ", " << node.element.second << ") ";
 }
 
-template <typename KK, typename VV, typename CC>
-void printLevelByLevel(const BinarySearchTree<KK, VV, CC>& bst, std::ostream & out = std::cout) {
-    using Node = typename BinarySearchTree<KK, VV, CC>::Node;
+template <typename KK, typename VV, typename CC, typename BB>
+void printLevelByLevel(const BinarySearchTree<KK, VV, CC, BB>& bst, std::ostream & out = std::cout) {
+    using Node = typename BinarySearchTree<KK, VV, CC, BB>::Node;
 
     if (bst._root == nullptr) { return; }
 
@@ -286,7 +775,7 @@ void printLevelByLevel(const BinarySearchTree<KK, VV, CC>& bst, std::ostream & o
         q.pop();
         elementsInLevel--;
         if (node != nullptr) {
-            printNode<KK, VV, CC>(out, *node);
+            printNode<KK, VV, CC, BB>(out, *node);
             q.push(node->left);
             q.push(node->right);
             if (node->left != nullptr || node->right != nullptr) { nonNullChild = true; }
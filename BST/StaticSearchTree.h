@@ -0,0 +1,192 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional> // std::less
+#include <iterator>
+#include <stdexcept>
+#include <utility> // std::pair
+#include <vector>
+
+#include "../Vector/AlignedAllocator.h"
+#include "BinarySearchTree.h"
+
+/**
+ * @brief Read-only ordered map for data that is built once and then only queried. The keys are stored in one
+ *        cache-line-aligned array in Eytzinger (breadth-first) order: the children of slot k are slots 2k and
+ *        2k + 1, so a search is an implicit walk down a perfectly balanced tree with no pointers to chase.
+ *        The walk is branch-free (the comparison result becomes the next index), and the descendants a few
+ *        levels down, which share a cache line, are prefetched while the current level is compared.
+ *
+ *        Built from a sorted range of (key, value) pairs with strictly increasing keys, or from a
+ *        BinarySearchTree. K and V must be default constructible.
+ */
+template <typename K, typename V, typename Comparator = std::less<K>>
+class StaticSearchTree {
+
+    public:
+        using key_type        = K;
+        using value_type      = V;
+        using pair            = std::pair<key_type, value_type>;
+        using size_type       = size_t;
+        using difference_type = ptrdiff_t;
+
+        static constexpr size_type cache_line_size = 64;
+
+    private:
+        // keys[0] and items[0] are unused so that the root is slot 1; with keys[0] at the start of a cache
+        // line, the 2^d descendants of a slot d levels down share one line. items holds the same slots as
+        // whole pairs for iteration and lookups, so searches only touch the compact key array
+        std::vector<key_type, AlignedAllocator<key_type, cache_line_size>> keys;
+        std::vector<pair> items;
+        size_type _size;
+        Comparator comp;
+
+        // how many levels ahead to prefetch: the descendants that level down fill one cache line
+        static constexpr size_type prefetch_stride = (sizeof(key_type) >= cache_line_size) ? 1 : cache_line_size / sizeof(key_type);
+
+        // the first slot in key order: the leftmost descendant of the root
+        size_type first_slot() const {
+            if (_size == 0) { return 0; }
+            return size_type(1) << (std::bit_width(_size) - 1);
+        }
+
+        // the slot after k in key order, or 0 after the last one
+        size_type next_slot(size_type k) const {
+            if (2 * k + 1 <= _size) {
+                k = 2 * k + 1;
+                while (2 * k <= _size) { k = 2 * k; }
+                return k;
+            }
+            // climb past every ancestor we are the right child of, then once more
+            return k >> (std::countr_one(k) + 1);
+        }
+
+        void prefetch(size_type k) const {
+#if defined(__GNUC__)
+            if constexpr (prefetch_stride > 1) {
+                // plain integer arithmetic: the address may lie past the end, which prefetching tolerates
+                __builtin_prefetch(reinterpret_cast<const void*>(reinterpret_cast<uintptr_t>(keys.data()) + k * prefetch_stride * sizeof(key_type)));
+            }
+#endif
+        }
+
+        /**
+         * @brief Walk down until falling off the tree; going right whenever the slot's key compares below the
+         *        search key. The path then ends in a run of right turns after the last left turn, which was taken
+         *        at the answer; shifting them out of k recovers that slot (0 if there was no left turn).
+         */
+        size_type lower_bound_slot(const key_type & key) const {
+            size_type k = 1;
+            while (k <= _size) {
+                prefetch(k);
+                k = 2 * k + comp(keys[k], key);
+            }
+            return k >> (std::countr_one(k) + 1);
+        }
+
+        size_type upper_bound_slot(const key_type & key) const {
+            size_type k = 1;
+            while (k <= _size) {
+                prefetch(k);
+                k = 2 * k + !comp(key, keys[k]);
+            }
+            return k >> (std::countr_one(k) + 1);
+        }
+
+    public:
+    // in-order iterator over the stored (key, value) pairs; end() is slot 0
+    class const_iterator {
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = pair;
+            using difference_type   = ptrdiff_t;
+            using pointer           = const pair*;
+            using reference         = const pair&;
+
+        private:
+            friend class StaticSearchTree;
+
+            const StaticSearchTree* tree;
+            size_type slot;
+
+            const_iterator(const StaticSearchTree* tree, size_type slot) noexcept : tree{tree}, slot{slot} {}
+
+        public:
+            const_iterator() : tree{nullptr}, slot{0} {};
+
+            reference operator*() const { return tree->items[slot]; }
+
+            pointer operator->() const { return &tree->items[slot]; }
+
+            const key_type & key() const { return tree->items[slot].first; }
+
+            const V & value() const { return tree->items[slot].second; }
+
+            // Prefix Increment: ++a
+            const_iterator& operator++() { slot = tree->next_slot(slot); return *this; }
+
+            // Postfix Increment: a++
+            const_iterator operator++(int) { const_iterator result = *this; ++(*this) ; return result; }
+
+            friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) noexcept { return lhs.slot == rhs.slot; }
+
+            friend bool operator!=(const const_iterator& lhs, const const_iterator& rhs) noexcept { return !(lhs == rhs); }
+    };
+
+        using iterator = const_iterator;
+
+        StaticSearchTree() : keys(1), items(1), _size(0), comp(Comparator{}) {}
+
+        template <typename ForwardIt>
+        StaticSearchTree(ForwardIt first, ForwardIt last) : StaticSearchTree() { build_from_sorted(first, last); }
+
+        template <typename BalancingPolicy>
+        explicit StaticSearchTree(const BinarySearchTree<K, V, Comparator, BalancingPolicy> & tree) : StaticSearchTree() {
+            build_from_sorted(tree.begin(), tree.end());
+        }
+
+        /**
+         * @brief Replace the contents with the pairs in [first, last), which must be sorted by strictly increasing key.
+         */
+        template <typename ForwardIt>
+        void build_from_sorted(ForwardIt first, ForwardIt last) {
+            _size = static_cast<size_type>(std::distance(first, last));
+            keys.assign(_size + 1, key_type());
+            items.assign(_size + 1, pair());
+
+            // an in-order walk of the implicit tree visits the slots in key order
+            for (size_type k = first_slot(); k != 0; k = next_slot(k), ++first) {
+                keys[k] = first->first;
+                items[k] = pair(first->first, first->second);
+            }
+        }
+
+        bool empty() const { return _size == 0; }
+
+        size_type size() const { return _size; }
+
+        bool contains(const key_type & key) const {
+            size_type k = lower_bound_slot(key);
+            return k != 0 && !comp(key, keys[k]);
+        }
+
+        // The value stored under key; throws std::out_of_range if there is none
+        const value_type & find(const key_type & key) const {
+            size_type k = lower_bound_slot(key);
+            if (k == 0 || comp(key, keys[k])) { throw std::out_of_range("StaticSearchTree::find"); }
+            return items[k].second;
+        }
+
+        const_iterator begin() const { return const_iterator(this, first_slot()); }
+
+        const_iterator end() const { return const_iterator(this, 0); }
+
+        // Return an iterator to the first pair whose key is not less than key, or end()
+        const_iterator lower_bound(const key_type & key) const { return const_iterator(this, lower_bound_slot(key)); }
+
+        // Return an iterator to the first pair whose key is greater than key, or end()
+        const_iterator upper_bound(const key_type & key) const { return const_iterator(this, upper_bound_slot(key)); }
+};
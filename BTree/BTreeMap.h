@@ -0,0 +1,621 @@
+#pragma once
+
+#include <cstddef>
+#include <functional> // std::less
+#include <iterator>
+#include <stdexcept>
+#include <utility> // std::pair
+
+namespace {
+    // number of entries that fit, next to the node header, in about four cache lines (at least 4)
+    constexpr size_t btree_capacity(size_t entry_size) {
+        size_t count = (256 - 2 * sizeof(void*)) / entry_size;
+        return (count < 4) ? 4 : count;
+    }
+}
+
+/**
+ * @brief Ordered map stored as a B+ tree. Internal nodes hold only sorted separator keys and child pointers,
+ *        packed into a few cache lines, so a lookup takes one or two cache misses per level instead of one per
+ *        key comparison, and the tree is log_B(n) levels deep instead of log_2(n). The (key, value) pairs live in
+ *        the leaves, which are linked in key order, so ordered iteration and range scans walk consecutive arrays.
+ *
+ *        Same interface as BinarySearchTree (insert overwrites the value of an existing key), plus bidirectional
+ *        iterators and lower_bound / upper_bound. K and V must be default constructible. Any insert or erase
+ *        invalidates iterators.
+ */
+template <typename K, typename V, typename Comparator = std::less<K>,
+          size_t LeafCapacity = btree_capacity(sizeof(std::pair<K, V>)),
+          size_t InternalCapacity = btree_capacity(sizeof(K) + sizeof(void*))>
+class BTreeMap {
+    static_assert(LeafCapacity >= 4 && InternalCapacity >= 4, "B-tree nodes need room for at least four entries");
+
+    public:
+        using key_type        = K;
+        using value_type      = V;
+        using pair            = std::pair<key_type, value_type>;
+        using pointer         = pair*;
+        using const_pointer   = const pair*;
+        using reference       = pair&;
+        using const_reference = const pair&;
+        using size_type       = size_t;
+        using difference_type = ptrdiff_t;
+
+    private:
+        struct Node {
+            bool leaf;
+            size_type count;
+
+            explicit Node(bool leaf) : leaf{leaf}, count{0} {}
+        };
+
+        struct Leaf : Node {
+            pair items[LeafCapacity];
+            Leaf* prev;
+            Leaf* next;
+
+            Leaf() : Node(true), prev{nullptr}, next{nullptr} {}
+        };
+
+        // count keys and count + 1 children; every key in children[i] is less than keys[i],
+        // and every key in children[i + 1] is not
+        struct Internal : Node {
+            key_type keys[InternalCapacity];
+            Node* children[InternalCapacity + 1];
+
+            Internal() : Node(false) {}
+        };
+
+        static constexpr size_type min_leaf = LeafCapacity / 2;
+        static constexpr size_type min_internal = InternalCapacity / 2;
+
+        static Leaf* as_leaf(Node* node) { return static_cast<Leaf*>(node); }
+        static const Leaf* as_leaf(const Node* node) { return static_cast<const Leaf*>(node); }
+        static Internal* as_internal(Node* node) { return static_cast<Internal*>(node); }
+        static const Internal* as_internal(const Node* node) { return static_cast<const Internal*>(node); }
+
+    template <typename pointer_type, typename reference_type, typename leaf_pointer>
+    class basic_iterator {
+
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type        = pair;
+            using difference_type   = ptrdiff_t;
+            using pointer           = pointer_type;
+            using reference         = reference_type;
+
+        private:
+            friend class BTreeMap;
+
+            leaf_pointer leaf;
+            size_type index;
+
+            basic_iterator(leaf_pointer leaf, size_type index) noexcept : leaf{leaf}, index{index} {}
+
+        public:
+            basic_iterator() : leaf{nullptr}, index{0} {};
+
+            // iterator -> const_iterator
+            operator basic_iterator<const pair*, const pair&, const Leaf*>() const noexcept {
+                return basic_iterator<const pair*, const pair&, const Leaf*>(leaf, index);
+            }
+
+            reference operator*() const { return leaf->items[index]; }
+
+            pointer operator->() const { return &(leaf->items[index]); }
+
+            // Prefix Increment: ++a
+            basic_iterator& operator++() {
+                if (++index == leaf->count && leaf->next != nullptr) { leaf = leaf->next; index = 0; }
+                return *this;
+            }
+
+            // Postfix Increment: a++
+            basic_iterator operator++(int) { basic_iterator result = *this; ++(*this) ; return result; }
+
+            // Prefix Decrement: --a
+            basic_iterator& operator--() {
+                if (index == 0) { leaf = leaf->prev; index = leaf->count; }
+                index--;
+                return *this;
+            }
+
+            // Postfix Decrement: a--
+            basic_iterator operator--(int) { basic_iterator result = *this; --(*this) ; return result; }
+
+            friend bool operator==(const basic_iterator& lhs, const basic_iterator& rhs) noexcept {
+                return lhs.leaf == rhs.leaf && lhs.index == rhs.index;
+            }
+
+            friend bool operator!=(const basic_iterator& lhs, const basic_iterator& rhs) noexcept { return !(lhs == rhs); }
+    };
+
+    public:
+        using iterator       = basic_iterator<pointer, reference, Leaf*>;
+        using const_iterator = basic_iterator<const_pointer, const_reference, const Leaf*>;
+
+    private:
+        Node* _root;
+        Leaf* _first;
+        Leaf* _last;
+        size_type _size;
+        Comparator comp;
+
+    public:
+        BTreeMap() : _root(nullptr), _first(nullptr), _last(nullptr), _size(0), comp(Comparator{}) {}
+
+        // Copy constructor
+        BTreeMap(const BTreeMap & rhs) : _root(nullptr), _first(nullptr), _last(nullptr), _size(rhs._size), comp(Comparator{}) {
+            Leaf* previous = nullptr;
+            _root = clone(rhs._root, previous);
+            _last = previous;
+        }
+
+        void swap(BTreeMap & src, BTreeMap & dst) {
+            std::swap(src._root, dst._root);
+            std::swap(src._first, dst._first);
+            std::swap(src._last, dst._last);
+            std::swap(src._size, dst._size);
+        }
+
+        // Move constructor
+        BTreeMap(BTreeMap && rhs) : _root(nullptr), _first(nullptr), _last(nullptr), _size(0), comp(Comparator{}) {
+            swap(*this, rhs);
+        }
+
+        // Copy assignment operator
+        BTreeMap & operator=(const BTreeMap & rhs) {
+            if (this != &rhs) {
+                BTreeMap copy(rhs);
+                swap(*this, copy);
+            }
+            return *this;
+        }
+
+        // Move assignment operator
+        BTreeMap & operator=(BTreeMap && rhs) {
+            if (this != &rhs) {
+                clear();
+                swap(*this, rhs);
+            }
+            return *this;
+        }
+
+        // Destructor
+        ~BTreeMap() {
+            clear();
+        }
+
+        const_reference min() const { return _first->items[0]; }
+
+        const_reference max() const { return _last->items[_last->count - 1]; }
+
+
+        bool contains(const key_type & key) const {
+            const_iterator it = lower_bound(key);
+            return it != end() && !comp(key, it->first);
+        }
+
+        // The value stored under key; throws std::out_of_range if there is none
+        value_type & find(const key_type & key) {
+            return const_cast<value_type&>(static_cast<const BTreeMap&>(*this).find(key));
+        }
+
+        const value_type & find(const key_type & key) const {
+            const_iterator it = lower_bound(key);
+            if (it == end() || comp(key, it->first)) { throw std::out_of_range("BTreeMap::find"); }
+            return it->second;
+        }
+
+
+        bool empty() const { return _size == 0; }
+
+        size_type size() const { return _size; }
+
+        void clear() {
+            destroy(_root);
+            _root = nullptr;
+            _first = _last = nullptr;
+            _size = 0;
+        }
+
+
+        void insert(const pair & x) { insert_pair(x); }
+
+        void insert(pair && x) { insert_pair(std::move(x)); }
+
+        void erase(const key_type & key) {
+            if (_root == nullptr) { return; }
+
+            erase(key, _root);
+
+            // shrink the tree when the root runs out of keys
+            if (!_root->leaf && _root->count == 0) {
+                Node* old = _root;
+                _root = as_internal(old)->children[0];
+                delete as_internal(old);
+            }
+            else if (_root->leaf && _root->count == 0) {
+                delete as_leaf(_root);
+                _root = nullptr;
+                _first = _last = nullptr;
+            }
+        }
+
+
+        iterator begin() { return iterator(_first, 0); }
+
+        const_iterator begin() const { return const_iterator(_first, 0); }
+
+        iterator end() { return iterator(_last, (_last == nullptr) ? 0 : _last->count); }
+
+        const_iterator end() const { return const_iterator(_last, (_last == nullptr) ? 0 : _last->count); }
+
+        /**
+         * @brief Return an iterator to the first pair whose key is not less than key, or end().
+         */
+        iterator lower_bound(const key_type & key) {
+            const_iterator it = static_cast<const BTreeMap&>(*this).lower_bound(key);
+            return iterator(const_cast<Leaf*>(it.leaf), it.index);
+        }
+
+        const_iterator lower_bound(const key_type & key) const {
+            if (_root == nullptr) { return end(); }
+
+            const Leaf* leaf = descend(key);
+            return normalize(leaf, leaf_lower_bound(leaf, key));
+        }
+
+        /**
+         * @brief Return an iterator to the first pair whose key is greater than key, or end().
+         */
+        iterator upper_bound(const key_type & key) {
+            const_iterator it = static_cast<const BTreeMap&>(*this).upper_bound(key);
+            return iterator(const_cast<Leaf*>(it.leaf), it.index);
+        }
+
+        const_iterator upper_bound(const key_type & key) const {
+            if (_root == nullptr) { return end(); }
+
+            const Leaf* leaf = descend(key);
+            return normalize(leaf, leaf_upper_bound(leaf, key));
+        }
+
+    private:
+        // Positions within a node are found by counting the keys on the wrong side of the search key.
+        // The nodes are small and sorted, so this branch-free linear count beats a binary search.
+
+        // index of the child of node that may hold key
+        size_type child_index(const Internal* node, const key_type & key) const {
+            size_type index = 0;
+            for (size_type i = 0; i < node->count; i++) { index += !comp(key, node->keys[i]); }
+            return index;
+        }
+
+        size_type leaf_lower_bound(const Leaf* leaf, const key_type & key) const {
+            size_type index = 0;
+            for (size_type i = 0; i < leaf->count; i++) { index += comp(leaf->items[i].first, key); }
+            return index;
+        }
+
+        size_type leaf_upper_bound(const Leaf* leaf, const key_type & key) const {
+            size_type index = 0;
+            for (size_type i = 0; i < leaf->count; i++) { index += !comp(key, leaf->items[i].first); }
+            return index;
+        }
+
+        const Leaf* descend(const key_type & key) const {
+            const Node* node = _root;
+            while (!node->leaf) {
+                const Internal* internal = as_internal(node);
+                node = internal->children[child_index(internal, key)];
+            }
+            return as_leaf(node);
+        }
+
+        // a position one past the end of a leaf is the start of the next leaf (or end())
+        const_iterator normalize(const Leaf* leaf, size_type index) const {
+            if (index == leaf->count && leaf->next != nullptr) { return const_iterator(leaf->next, 0); }
+            return const_iterator(leaf, index);
+        }
+
+        template <typename P>
+        void insert_pair(P && x) {
+            if (_root == nullptr) {
+                Leaf* leaf = new Leaf();
+                _root = _first = _last = leaf;
+            }
+
+            key_type separator;
+            Node* right = insert(std::forward<P>(x), _root, separator);
+
+            if (right != nullptr) {
+                Internal* root = new Internal();
+                root->count = 1;
+                root->keys[0] = std::move(separator);
+                root->children[0] = _root;
+                root->children[1] = right;
+                _root = root;
+            }
+        }
+
+        /**
+         * @brief Insert x into the subtree at node.
+         * @return the new right sibling if node had to split (separator receives its smallest key), else nullptr
+         */
+        template <typename P>
+        Node* insert(P && x, Node* node, key_type & separator) {
+            if (node->leaf) { return insert_into_leaf(std::forward<P>(x), as_leaf(node), separator); }
+
+            Internal* internal = as_internal(node);
+            size_type index = child_index(internal, x.first);
+
+            key_type child_separator;
+            Node* child_right = insert(std::forward<P>(x), internal->children[index], child_separator);
+            if (child_right == nullptr) { return nullptr; }
+
+            if (internal->count < InternalCapacity) {
+                insert_into_internal(internal, index, std::move(child_separator), child_right);
+                return nullptr;
+            }
+
+            // split: the upper half of the keys and children move to a new node, the middle key moves up
+            Internal* right = new Internal();
+            size_type mid = InternalCapacity / 2;
+
+            if (index < mid) {
+                move_internal_tail(internal, mid, right);
+                separator = std::move(internal->keys[mid - 1]);
+                internal->count = mid - 1;
+                insert_into_internal(internal, index, std::move(child_separator), child_right);
+            }
+            else if (index > mid) {
+                move_internal_tail(internal, mid + 1, right);
+                separator = std::move(internal->keys[mid]);
+                internal->count = mid;
+                insert_into_internal(right, index - mid - 1, std::move(child_separator), child_right);
+            }
+            else {
+                // the key coming up from the child is itself the middle key
+                move_internal_tail(internal, mid, right);
+                right->children[0] = child_right;
+                separator = std::move(child_separator);
+                internal->count = mid;
+            }
+
+            return right;
+        }
+
+        // moves keys[from, count) and children[from, count] of node to the front of the empty node right
+        void move_internal_tail(Internal* node, size_type from, Internal* right) {
+            for (size_type i = from; i < node->count; i++) {
+                right->keys[i - from] = std::move(node->keys[i]);
+                right->children[i - from + 1] = node->children[i + 1];
+            }
+            right->children[0] = node->children[from];
+            right->count = node->count - from;
+        }
+
+        // puts separator at keys[index] and right at children[index + 1]; node must have room
+        void insert_into_internal(Internal* node, size_type index, key_type && separator, Node* right) {
+            for (size_type i = node->count; i > index; i--) {
+                node->keys[i] = std::move(node->keys[i - 1]);
+                node->children[i + 1] = node->children[i];
+            }
+            node->keys[index] = std::move(separator);
+            node->children[index + 1] = right;
+            node->count++;
+        }
+
+        template <typename P>
+        Node* insert_into_leaf(P && x, Leaf* leaf, key_type & separator) {
+            size_type index = leaf_lower_bound(leaf, x.first);
+
+            if (index < leaf->count && !comp(x.first, leaf->items[index].first)) {
+                leaf->items[index].second = std::forward<P>(x).second;
+                return nullptr;
+            }
+
+            _size++;
+
+            if (leaf->count < LeafCapacity) {
+                insert_into_leaf_at(leaf, index, std::forward<P>(x));
+                return nullptr;
+            }
+
+            // split: the upper half moves to a new leaf linked in after this one
+            Leaf* right = new Leaf();
+            size_type mid = LeafCapacity / 2;
+
+            for (size_type i = mid; i < leaf->count; i++) {
+                right->items[i - mid] = std::move(leaf->items[i]);
+                vacate(leaf->items[i]);
+            }
+            right->count = leaf->count - mid;
+            leaf->count = mid;
+
+            right->next = leaf->next;
+            right->prev = leaf;
+            if (leaf->next != nullptr) { leaf->next->prev = right; } else { _last = right; }
+            leaf->next = right;
+
+            if (index <= mid) {
+                insert_into_leaf_at(leaf, index, std::forward<P>(x));
+            }
+            else {
+                insert_into_leaf_at(right, index - mid, std::forward<P>(x));
+            }
+
+            separator = right->items[0].first;
+            return right;
+        }
+
+        // slots past a leaf's count are kept default constructed, so a removed pair releases what it holds now
+        // rather than when its leaf is freed
+        static void vacate(pair & slot) { slot = pair(); }
+
+        template <typename P>
+        void insert_into_leaf_at(Leaf* leaf, size_type index, P && x) {
+            for (size_type i = leaf->count; i > index; i--) { leaf->items[i] = std::move(leaf->items[i - 1]); }
+            leaf->items[index] = std::forward<P>(x);
+            leaf->count++;
+        }
+
+        /**
+         * @brief Erase key from the subtree at node; children that fall below half full borrow from or merge
+         *        with a sibling on the way back up.
+         */
+        void erase(const key_type & key, Node* node) {
+            if (node->leaf) {
+                Leaf* leaf = as_leaf(node);
+                size_type index = leaf_lower_bound(leaf, key);
+                if (index == leaf->count || comp(key, leaf->items[index].first)) { return; }
+
+                for (size_type i = index + 1; i < leaf->count; i++) { leaf->items[i - 1] = std::move(leaf->items[i]); }
+                vacate(leaf->items[--leaf->count]);
+                _size--;
+                return;
+            }
+
+            Internal* internal = as_internal(node);
+            size_type index = child_index(internal, key);
+            Node* child = internal->children[index];
+
+            erase(key, child);
+
+            if (child->leaf) {
+                if (child->count < min_leaf) { fix_leaf(internal, index); }
+            }
+            else if (child->count < min_internal) {
+                fix_internal(internal, index);
+            }
+        }
+
+        void fix_leaf(Internal* parent, size_type index) {
+            Leaf* child = as_leaf(parent->children[index]);
+            Leaf* left = (index > 0) ? as_leaf(parent->children[index - 1]) : nullptr;
+            Leaf* right = (index < parent->count) ? as_leaf(parent->children[index + 1]) : nullptr;
+
+            if (left != nullptr && left->count > min_leaf) {
+                insert_into_leaf_at(child, 0, std::move(left->items[--left->count]));
+                vacate(left->items[left->count]);
+                parent->keys[index - 1] = child->items[0].first;
+            }
+            else if (right != nullptr && right->count > min_leaf) {
+                child->items[child->count++] = std::move(right->items[0]);
+                for (size_type i = 1; i < right->count; i++) { right->items[i - 1] = std::move(right->items[i]); }
+                vacate(right->items[--right->count]);
+                parent->keys[index] = right->items[0].first;
+            }
+            else if (left != nullptr) {
+                merge_leaves(left, child);
+                remove_from_internal(parent, index - 1);
+            }
+            else {
+                merge_leaves(child, right);
+                remove_from_internal(parent, index);
+            }
+        }
+
+        // appends right's items to left and deletes right
+        void merge_leaves(Leaf* left, Leaf* right) {
+            for (size_type i = 0; i < right->count; i++) { left->items[left->count + i] = std::move(right->items[i]); }
+            left->count += right->count;
+
+            left->next = right->next;
+            if (right->next != nullptr) { right->next->prev = left; } else { _last = left; }
+            delete right;
+        }
+
+        void fix_internal(Internal* parent, size_type index) {
+            Internal* child = as_internal(parent->children[index]);
+            Internal* left = (index > 0) ? as_internal(parent->children[index - 1]) : nullptr;
+            Internal* right = (index < parent->count) ? as_internal(parent->children[index + 1]) : nullptr;
+
+            if (left != nullptr && left->count > min_internal) {
+                // rotate right through the parent
+                for (size_type i = child->count; i > 0; i--) { child->keys[i] = std::move(child->keys[i - 1]); }
+                for (size_type i = child->count + 1; i > 0; i--) { child->children[i] = child->children[i - 1]; }
+                child->keys[0] = std::move(parent->keys[index - 1]);
+                child->children[0] = left->children[left->count];
+                child->count++;
+
+                parent->keys[index - 1] = std::move(left->keys[left->count - 1]);
+                left->count--;
+            }
+            else if (right != nullptr && right->count > min_internal) {
+                // rotate left through the parent
+                child->keys[child->count] = std::move(parent->keys[index]);
+                child->children[child->count + 1] = right->children[0];
+                child->count++;
+
+                parent->keys[index] = std::move(right->keys[0]);
+                for (size_type i = 1; i < right->count; i++) { right->keys[i - 1] = std::move(right->keys[i]); }
+                for (size_type i = 1; i <= right->count; i++) { right->children[i - 1] = right->children[i]; }
+                right->count--;
+            }
+            else if (left != nullptr) {
+                merge_internals(left, std::move(parent->keys[index - 1]), child);
+                remove_from_internal(parent, index - 1);
+            }
+            else {
+                merge_internals(child, std::move(parent->keys[index]), right);
+                remove_from_internal(parent, index);
+            }
+        }
+
+        // appends separator and right's keys and children to left and deletes right
+        void merge_internals(Internal* left, key_type && separator, Internal* right) {
+            left->keys[left->count] = std::move(separator);
+            for (size_type i = 0; i < right->count; i++) { left->keys[left->count + 1 + i] = std::move(right->keys[i]); }
+            for (size_type i = 0; i <= right->count; i++) { left->children[left->count + 1 + i] = right->children[i]; }
+            left->count += right->count + 1;
+            delete right;
+        }
+
+        // removes keys[index] and children[index + 1]
+        void remove_from_internal(Internal* node, size_type index) {
+            for (size_type i = index + 1; i < node->count; i++) {
+                node->keys[i - 1] = std::move(node->keys[i]);
+                node->children[i] = node->children[i + 1];
+            }
+            node->count--;
+        }
+
+        void destroy(Node* node) {
+            if (node == nullptr) { return; }
+
+            if (node->leaf) {
+                delete as_leaf(node);
+                return;
+            }
+
+            Internal* internal = as_internal(node);
+            for (size_type i = 0; i <= internal->count; i++) { destroy(internal->children[i]); }
+            delete internal;
+        }
+
+        // copies the subtree at node; previous is the last leaf copied so far, used to link the leaves
+        Node* clone(const Node* node, Leaf*& previous) {
+            if (node == nullptr) { return nullptr; }
+
+            if (node->leaf) {
+                const Leaf* leaf = as_leaf(node);
+                Leaf* copy = new Leaf();
+                for (size_type i = 0; i < leaf->count; i++) { copy->items[i] = leaf->items[i]; }
+                copy->count = leaf->count;
+
+                copy->prev = previous;
+                if (previous != nullptr) { previous->next = copy; } else { _first = copy; }
+                previous = copy;
+                return copy;
+            }
+
+            const Internal* internal = as_internal(node);
+            Internal* copy = new Internal();
+            for (size_type i = 0; i < internal->count; i++) { copy->keys[i] = internal->keys[i]; }
+            for (size_type i = 0; i <= internal->count; i++) { copy->children[i] = clone(internal->children[i], previous); }
+            copy->count = internal->count;
+            return copy;
+        }
+};
@@ -0,0 +1,347 @@
+#ifndef DEQUE_H
+#define DEQUE_H
+
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+    // largest power of two number of elements fitting in about 4 KB, but at least 16
+    template <typename T>
+    constexpr size_t default_deque_block_size() {
+        size_t count = 16;
+        while (count * 2 * sizeof(T) <= 4096) { count *= 2; }
+        return count;
+    }
+}
+
+// Double-ended queue stored as a ring of fixed-size blocks. Elements never move once constructed, and
+// push/pop at either end is O(1) with no per-element allocation. Blocks emptied at one end are kept and
+// rotated to the other end, so a FIFO whose occupancy stays bounded stops allocating after warming up.
+template <class T, size_t BlockSize = default_deque_block_size<T>()>
+class Deque {
+    static_assert(BlockSize > 0 && (BlockSize & (BlockSize - 1)) == 0, "BlockSize must be a power of two");
+
+    template <typename pointer_type, typename reference_type, typename deque_pointer>
+    class basic_iterator {
+
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type        = T;
+            using difference_type   = ptrdiff_t;
+            using pointer           = pointer_type;
+            using reference         = reference_type;
+
+        private:
+            friend class Deque<value_type, BlockSize>;
+
+            deque_pointer deque;
+            size_t index;
+
+            basic_iterator(deque_pointer deque, size_t index) noexcept : deque{deque}, index{index} {}
+
+        public:
+            basic_iterator() : deque{nullptr}, index{0} {};
+
+            // iterator -> const_iterator
+            operator basic_iterator<const T*, const T&, const Deque*>() const noexcept {
+                return basic_iterator<const T*, const T&, const Deque*>(deque, index);
+            }
+
+            reference operator*() const { return (*deque)[index]; }
+
+            pointer operator->() const { return &(*deque)[index]; }
+
+            reference operator[](difference_type offset) const { return (*deque)[index + offset]; }
+
+            // Prefix Increment: ++a
+            basic_iterator& operator++() { index++; return *this; }
+
+            // Postfix Increment: a++
+            basic_iterator operator++(int) { basic_iterator result = *this; ++(*this); return result; }
+
+            // Prefix Decrement: --a
+            basic_iterator& operator--() { index--; return *this; }
+
+            // Postfix Decrement: a--
+            basic_iterator operator--(int) { basic_iterator result = *this; --(*this); return result; }
+
+            basic_iterator& operator+=(difference_type offset) { index += offset; return *this; }
+
+            basic_iterator& operator-=(difference_type offset) { index -= offset; return *this; }
+
+            basic_iterator operator+(difference_type offset) const { return basic_iterator(deque, index + offset); }
+
+            basic_iterator operator-(difference_type offset) const { return basic_iterator(deque, index - offset); }
+
+            friend basic_iterator operator+(difference_type offset, const basic_iterator& it) { return it + offset; }
+
+            friend difference_type operator-(const basic_iterator& lhs, const basic_iterator& rhs) {
+                return static_cast<difference_type>(lhs.index) - static_cast<difference_type>(rhs.index);
+            }
+
+            friend bool operator==(const basic_iterator& lhs, const basic_iterator& rhs) noexcept { return lhs.index == rhs.index; }
+            friend bool operator!=(const basic_iterator& lhs, const basic_iterator& rhs) noexcept { return lhs.index != rhs.index; }
+            friend bool operator<(const basic_iterator& lhs, const basic_iterator& rhs) noexcept { return lhs.index < rhs.index; }
+            friend bool operator>(const basic_iterator& lhs, const basic_iterator& rhs) noexcept { return lhs.index > rhs.index; }
+            friend bool operator<=(const basic_iterator& lhs, const basic_iterator& rhs) noexcept { return lhs.index <= rhs.index; }
+            friend bool operator>=(const basic_iterator& lhs, const basic_iterator& rhs) noexcept { return lhs.index >= rhs.index; }
+    };
+
+    public:
+        using value_type      = T;
+        using pointer         = value_type*;
+        using const_pointer   = const value_type*;
+        using reference       = value_type&;
+        using const_reference = const value_type&;
+        using iterator        = basic_iterator<pointer, reference, Deque*>;
+        using const_iterator  = basic_iterator<const_pointer, const_reference, const Deque*>;
+        using size_type       = size_t;
+        using difference_type = ptrdiff_t;
+
+        static constexpr size_type block_size = BlockSize;
+
+    private:
+        // ring of block pointers; the _blocks allocated blocks are at ring positions first, first + 1, ...
+        T** map;
+        size_type map_capacity;
+        size_type first;
+        size_type _blocks;
+
+        // position of the front element inside the first block, and the number of elements
+        size_type offset;
+        size_type _size;
+
+        T*& block_at(size_type block) const noexcept { return map[(first + block) & (map_capacity - 1)]; }
+
+        T* slot(size_type index) const noexcept {
+            size_type position = offset + index;
+            return block_at(position / BlockSize) + position % BlockSize;
+        }
+
+        size_type used_blocks() const noexcept { return (offset + _size + BlockSize - 1) / BlockSize; }
+
+        static T* allocate_block() { return static_cast<T*>(::operator new(BlockSize * sizeof(T), std::align_val_t(alignof(T)))); }
+
+        static void deallocate_block(T* block) noexcept { ::operator delete(block, std::align_val_t(alignof(T))); }
+
+        // doubles the ring, laying the blocks out again starting at position 0
+        void grow_map() {
+            size_type new_capacity = (map_capacity == 0) ? 8 : 2 * map_capacity;
+            T** new_map = new T*[new_capacity];
+
+            for (size_type i = 0; i < _blocks; i++) { new_map[i] = block_at(i); }
+
+            delete[] map;
+            map = new_map;
+            map_capacity = new_capacity;
+            first = 0;
+        }
+
+        // makes sure there is an allocated block after the last used one
+        void reserve_back_block() {
+            if (used_blocks() < _blocks) { return; }
+
+            if (_blocks == map_capacity) { grow_map(); }
+            block_at(_blocks) = allocate_block();
+            _blocks++;
+        }
+
+        // makes sure there is an allocated block in front of the first one and makes it the first
+        void reserve_front_block() {
+            if (_blocks > used_blocks()) {
+                T* spare = block_at(_blocks - 1);
+                first = (first + map_capacity - 1) & (map_capacity - 1);
+                block_at(0) = spare;
+                return;
+            }
+
+            if (_blocks == map_capacity) { grow_map(); }
+            T* block = allocate_block();
+            first = (first + map_capacity - 1) & (map_capacity - 1);
+            block_at(0) = block;
+            _blocks++;
+        }
+
+        // the first block is drained: rotate it behind the last allocated block for reuse
+        void recycle_front_block() noexcept {
+            T* drained = block_at(0);
+            block_at(_blocks) = drained;
+            first = (first + 1) & (map_capacity - 1);
+            offset = 0;
+        }
+
+        void release() noexcept {
+            clear();
+            for (size_type i = 0; i < _blocks; i++) { deallocate_block(block_at(i)); }
+            delete[] map;
+            map = nullptr;
+            map_capacity = first = _blocks = 0;
+        }
+
+        void steal(Deque& other) noexcept {
+            map = other.map; map_capacity = other.map_capacity; first = other.first;
+            _blocks = other._blocks; offset = other.offset; _size = other._size;
+
+            other.map = nullptr;
+            other.map_capacity = other.first = other._blocks = other.offset = other._size = 0;
+        }
+
+    public:
+        Deque() noexcept : map(nullptr), map_capacity(0), first(0), _blocks(0), offset(0), _size(0) {}
+
+        Deque(size_type count, const T& value) : Deque() {
+            for (size_type i = 0; i < count; i++) { push_back(value); }
+        }
+
+        explicit Deque(size_type count) : Deque() {
+            for (size_type i = 0; i < count; i++) { emplace_back(); }
+        }
+
+        // Copy constructor
+        Deque(const Deque& other) : Deque() {
+            try {
+                for (size_type i = 0; i < other._size; i++) { push_back(other[i]); }
+            }
+            catch (...) {
+                release();
+                throw;
+            }
+        }
+
+        // Move constructor
+        Deque(Deque&& other) noexcept : Deque() {
+            steal(other);
+        }
+
+        // Copy assignment operator
+        Deque& operator=(const Deque& other) {
+            if (this != &other) {
+                clear();
+                for (size_type i = 0; i < other._size; i++) { push_back(other[i]); }
+            }
+            return *this;
+        }
+
+        // Move assignment operator
+        Deque& operator=(Deque&& other) noexcept {
+            if (this != &other) {
+                release();
+                steal(other);
+            }
+            return *this;
+        }
+
+        // Destructor
+        ~Deque() {
+            release();
+        }
+
+        /**
+         * @brief Destroy all elements. The blocks stay allocated for reuse.
+         */
+        void clear() noexcept {
+            for (size_type i = 0; i < _size; i++) { slot(i)->~T(); }
+            _size = 0;
+            offset = 0;
+        }
+
+        reference operator[](size_type index) { return *slot(index); }
+
+        const_reference operator[](size_type index) const { return *slot(index); }
+
+        reference at(size_type index) {
+            if (index >= _size) { throw std::out_of_range("Deque::at"); }
+            return *slot(index);
+        }
+
+        const_reference at(size_type index) const {
+            if (index >= _size) { throw std::out_of_range("Deque::at"); }
+            return *slot(index);
+        }
+
+        reference front() { return *slot(0); }
+
+        const_reference front() const { return *slot(0); }
+
+        reference back() { return *slot(_size - 1); }
+
+        const_reference back() const { return *slot(_size - 1); }
+
+
+        iterator begin() noexcept { return iterator(this, 0); }
+
+        const_iterator begin() const noexcept { return const_iterator(this, 0); }
+
+        const_iterator cbegin() const noexcept { return const_iterator(this, 0); }
+
+        iterator end() noexcept { return iterator(this, _size); }
+
+        const_iterator end() const noexcept { return const_iterator(this, _size); }
+
+        const_iterator cend() const noexcept { return const_iterator(this, _size); }
+
+
+        bool empty() const noexcept { return _size == 0; }
+
+        size_type size() const noexcept { return _size; }
+
+
+        template <typename... Args>
+        reference emplace_back(Args&&... args) {
+            if ((offset + _size) % BlockSize == 0) { reserve_back_block(); }
+
+            T* element = slot(_size);
+            ::new (static_cast<void*>(element)) T(std::forward<Args>(args)...);
+            _size++;
+            return *element;
+        }
+
+        void push_back(const T& value) { emplace_back(value); }
+
+        void push_back(T&& value) { emplace_back(std::move(value)); }
+
+        void pop_back() {
+            slot(_size - 1)->~T();
+            _size--;
+            if (_size == 0) { offset = 0; }
+        }
+
+        template <typename... Args>
+        reference emplace_front(Args&&... args) {
+            bool new_block = (offset == 0);
+            if (new_block) { reserve_front_block(); }
+
+            size_type position = (new_block ? BlockSize : offset) - 1;
+            T* element = block_at(0) + position;
+            try {
+                ::new (static_cast<void*>(element)) T(std::forward<Args>(args)...);
+            }
+            catch (...) {
+                // hand the block we just put in front back to the end of the ring
+                if (new_block) { recycle_front_block(); }
+                throw;
+            }
+
+            offset = position;
+            _size++;
+            return *element;
+        }
+
+        void push_front(const T& value) { emplace_front(value); }
+
+        void push_front(T&& value) { emplace_front(std::move(value)); }
+
+        void pop_front() {
+            slot(0)->~T();
+            _size--;
+            offset++;
+
+            if (_size == 0) { offset = 0; }
+            else if (offset == BlockSize) { recycle_front_block(); }
+        }
+};
+
+#endif
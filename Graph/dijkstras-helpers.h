@@ -5,6 +5,7 @@
 
 #include "weighted-graph.hpp"
 #include "graph-types.h"
+#include "../PriorityQueue/AddressablePriorityQueue.h"
 
 // HINT when calling relax, you have to specify the template arugment.
 // Therefore, relax(u, v, w, d, p) doesn't work.
@@ -51,13 +52,14 @@ public:
     }
 };
 
+// min-heap of vertex labels ordered by their current distances
 template <typename T>
-void updateHeap(std::priority_queue<value_type<T>, std::vector<value_type<T>>, DijkstraComparator<T>>& q,
-std::unordered_map<value_type<T>, weight_type<T>>& distances)
+using DijkstraQueue = AddressablePriorityQueue<value_type<T>, DijkstraComparator<T>>;
+
+// moves v up the heap after relax lowered its distance; O(log n) through v's handle
+template <typename T>
+void updateHeap(DijkstraQueue<T>& q,
+std::unordered_map<value_type<T>, typename DijkstraQueue<T>::handle_type>& handles, const value_type<T>& v)
 {
-    std::make_heap(const_cast<value_type<T>*>(&q.top()),
-            const_cast<value_type<T>*>(&q.top()) + q.size(),
-            DijkstraComparator<T>{distances});
+    q.increase_key(handles.at(v), v);
 }
-
-
@@ -37,14 +37,15 @@ std::list<value_type<T>> dijkstrasAlgorithm(const WeightedGraph<T>& graph, verte
     std::unordered_map<value_type<T>, std::optional<value_type<T>>> predecessors;
 
     std::unordered_set<value_type<T>> s;
-    std::priority_queue<value_type<T>, std::vector<value_type<T>>, DijkstraComparator<T>> q(DijkstraComparator<T>{distances});
+    DijkstraQueue<T> q(DijkstraComparator<T>{distances});
+    std::unordered_map<value_type<T>, typename DijkstraQueue<T>::handle_type> handles;
 
     initializeSingleSource(graph, initial_node, distances, predecessors);
 
     std::list<value_type<T>> l;
 
     for (auto& item : graph) {
-        q.push(item.first);
+        handles[item.first] = q.push(item.first);
     }
 
     while (!(q.empty())) {
@@ -64,7 +65,7 @@ std::list<value_type<T>> dijkstrasAlgorithm(const WeightedGraph<T>& graph, verte
             auto w = pair.second;
             auto r = relax<T>(u, v, w, distances, predecessors);
             if (r) {
-                updateHeap<T>(q, distances);
+                updateHeap<T>(q, handles, v);
             }
         }
     }
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <cstddef> 
+#include <functional> 
 #include <iterator> 
 #include <type_traits> 
+#include <utility> 
 
 template
  <class T>
@@ -36,6 +38,7 @@ class List {
 
         private:
             friend class List<value_type>;
+            template <typename, typename> friend class basic_iterator;
             using Node = typename List<value_type>::Node;
 
             Node* node;
@@ -51,6 +54,9 @@ class List {
             basic_iterator& operator=(const basic_iterator&) = default;
             basic_iterator& operator=(basic_iterator&&) = default;
 
+            // iterator -> const_iterator, so that the const_iterator overloads (splice, ...) accept both
+            operator basic_iterator<const T*, const T&>() const noexcept { return basic_iterator<const T*, const T&>(node); }
+
             reference operator*() const { return node->data; }
 
             pointer operator->() const { return &(node->data); }
@@ -87,6 +93,59 @@ class List {
         Node head, tail;
         size_type _size;
 
+        // appends copies of other's elements by building the chain directly, then linking it to tail once
+        void append_copy(const List& other) {
+            Node* last = tail.prev;
+
+            try {
+                for (const Node* node = other.head.next; node != &other.tail; node = node->next) {
+                    last->next = new Node(node->data, last, nullptr);
+                    last = last->next;
+                    _size++;
+                }
+            }
+            catch (...) {
+                last->next = &tail;
+                tail.prev = last;
+                throw;
+            }
+
+            last->next = &tail;
+            tail.prev = last;
+        }
+
+        // unlinks [first, last) and relinks it in front of pos; the nodes themselves are not touched
+        static void transfer(Node* pos, Node* first, Node* last) noexcept {
+            if (first == last || pos == first || pos == last) { return; }
+
+            Node* final = last->prev;
+
+            first->prev->next = last;
+            last->prev = first->prev;
+
+            first->prev = pos->prev;
+            final->next = pos;
+            pos->prev->next = first;
+            pos->prev = final;
+        }
+
+        // merges two null-terminated singly linked chains; ties go to a so that the merge is stable. link points
+        // at the next pointer to fill, so no sentinel Node (and no T) has to be constructed
+        template <typename Compare>
+        static Node* merge_chains(Node* a, Node* b, Compare& comp) {
+            Node* result = nullptr;
+            Node** link = &result;
+
+            while (a != nullptr && b != nullptr) {
+                if (comp(b->data, a->data)) { *link = b; b = b->next; }
+                else { *link = a; a = a->next; }
+                link = &(*link)->next;
+            }
+            *link = (a != nullptr) ? a : b;
+
+            return result;
+        }
+
     public:
         List() : _size(0) { 
             head.next = &tail; 
@@ -115,8 +174,12 @@ class List {
         List(const List& other) : _size(0) {
             head.next = &tail; tail.prev = &head;
 
-            for (const_iterator it = other.begin(); it != other.end(); it++) {
-                push_back(*it);
+            try {
+                append_copy(other);
+            }
+            catch (...) {
+                clear();
+                throw;
             }
         }
 
@@ -142,10 +205,7 @@ class List {
         List& operator=(const List& other) {
             if (this != &other) {
                 clear();
-        
-                for (const_iterator it = other.begin(); it != other.end(); it++) {
-                    push_back(*it);
-                }
+                append_copy(other);
             }
             return *this;
         }
@@ -179,8 +239,18 @@ class List {
             clear();
         }
 
+        // walks the chain once, without maintaining the links of nodes that are about to be deleted
         void clear() noexcept {
-            while(!empty()) { pop_back(); }
+            Node* node = head.next;
+            while (node != &tail) {
+                Node* next = node->next;
+                delete node;
+                node = next;
+            }
+
+            head.next = &tail;
+            tail.prev = &head;
+            _size = 0;
         }
         
         reference front() { return head.next->data; }
@@ -305,6 +375,139 @@ class List {
     iterator erase(iterator pos) {
         return erase((const_iterator&)(pos));
     }
+
+    /**
+     * @brief Move all of other's elements in front of pos. No elements are copied or allocated, and
+     *        iterators to the moved elements stay valid (they now refer into this list).
+     */
+    void splice(const_iterator pos, List& other) {
+        if (this == &other || other.empty()) { return; }
+
+        transfer(pos.node, other.head.next, &other.tail);
+        _size += other._size;
+        other._size = 0;
+    }
+
+    void splice(const_iterator pos, List&& other) { splice(pos, other); }
+
+    /**
+     * @brief Move the element at it (from other, which may be this list) in front of pos.
+     *        This is the O(1) move-to-front of an LRU list: splice(begin(), *this, it).
+     */
+    void splice(const_iterator pos, List& other, const_iterator it) {
+        if (pos.node == it.node || pos.node == it.node->next) { return; }
+
+        transfer(pos.node, it.node, it.node->next);
+        if (this != &other) {
+            _size++;
+            other._size--;
+        }
+    }
+
+    void splice(const_iterator pos, List&& other, const_iterator it) { splice(pos, other, it); }
+
+    /**
+     * @brief Move the elements in [first, last) from other in front of pos. pos must not be inside the range.
+     *        Constant time within one list; linear in the length of the range between two lists, to keep size() O(1).
+     */
+    void splice(const_iterator pos, List& other, const_iterator first, const_iterator last) {
+        if (first == last) { return; }
+
+        if (this != &other) {
+            size_type count = 0;
+            for (const Node* node = first.node; node != last.node; node = node->next) { count++; }
+            _size += count;
+            other._size -= count;
+        }
+
+        transfer(pos.node, first.node, last.node);
+    }
+
+    void splice(const_iterator pos, List&& other, const_iterator first, const_iterator last) { splice(pos, other, first, last); }
+
+    /**
+     * @brief Merge the sorted list other into this sorted list by relinking nodes; other is left empty.
+     *        Stable: for equivalent elements, those of this list come first.
+     */
+    template <typename Compare>
+    void merge(List& other, Compare comp) {
+        if (this == &other || other.empty()) { return; }
+
+        Node* node = head.next;
+        Node* incoming = other.head.next;
+
+        while (node != &tail && incoming != &other.tail) {
+            if (comp(incoming->data, node->data)) {
+                Node* run_end = incoming->next;
+                while (run_end != &other.tail && comp(run_end->data, node->data)) { run_end = run_end->next; }
+
+                transfer(node, incoming, run_end);
+                incoming = run_end;
+            }
+            else {
+                node = node->next;
+            }
+        }
+
+        if (incoming != &other.tail) { transfer(&tail, incoming, &other.tail); }
+
+        _size += other._size;
+        other._size = 0;
+    }
+
+    void merge(List& other) { merge(other, std::less<T>()); }
+
+    template <typename Compare>
+    void merge(List&& other, Compare comp) { merge(other, comp); }
+
+    void merge(List&& other) { merge(other, std::less<T>()); }
+
+    /**
+     * @brief Stable, in-place bottom-up merge sort on the node links. Elements are never copied or moved and
+     *        iterators stay valid. Runs are kept in power-of-two sized bins, so no recursion is needed.
+     */
+    template <typename Compare>
+    void sort(Compare comp) {
+        if (_size < 2) { return; }
+
+        // bins[i] holds a sorted chain of 2^i nodes (or is empty); more than 2^64 nodes cannot exist
+        Node* bins[64] = {};
+        size_t filled = 0;
+
+        tail.prev->next = nullptr;
+        Node* node = head.next;
+
+        while (node != nullptr) {
+            Node* carry = node;
+            node = node->next;
+            carry->next = nullptr;
+
+            size_t i = 0;
+            for (; i < filled && bins[i] != nullptr; i++) {
+                carry = merge_chains(bins[i], carry, comp);
+                bins[i] = nullptr;
+            }
+            bins[i] = carry;
+            if (i == filled) { filled++; }
+        }
+
+        Node* sorted = nullptr;
+        for (size_t i = 0; i < filled; i++) {
+            if (bins[i] != nullptr) { sorted = (sorted == nullptr) ? bins[i] : merge_chains(bins[i], sorted, comp); }
+        }
+
+        // restore the prev links in a single pass
+        Node* prev = &head;
+        for (node = sorted; node != nullptr; node = node->next) {
+            prev->next = node;
+            node->prev = prev;
+            prev = node;
+        }
+        prev->next = &tail;
+        tail.prev = prev;
+    }
+
+    void sort() { sort(std::less<T>()); }
 };
 
 
@@ -1,8 +1,11 @@
 #ifndef QUEUE_H
 #define QUEUE_H
 #include "List.h"
+#include "../Deque/Deque.h"
 
-template <typename T, typename Container = List<T>>
+// Container defaults to the block-based Deque so that push/pop do not allocate per element;
+// any container with front/back/push_back/pop_front (e.g. List<T>) still works.
+template <typename T, typename Container = Deque<T>>
 class Queue {
 
     template <typename T1, typename C1>
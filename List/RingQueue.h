@@ -0,0 +1,235 @@
+#ifndef RING_QUEUE_H
+#define RING_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Bounded multi-producer/multi-consumer queue on a power-of-two ring buffer (Dmitry Vyukov's design).
+// Every slot carries a sequence number telling producers and consumers whose turn it is, so a push or
+// pop is one CAS on the shared position plus one release store on the slot, with no locks and no allocation.
+// The bulk operations claim a whole run of slots with a single CAS.
+template <typename T>
+class RingQueue {
+    // a claimed slot must be published, so the element is built before claiming and moved in afterwards
+    static_assert(std::is_nothrow_move_constructible<T>::value,
+                  "RingQueue elements must be nothrow move constructible");
+
+    public:
+        using value_type      = T;
+        using size_type       = size_t;
+        using reference       = T&;
+        using const_reference = const T&;
+
+        static constexpr size_type cache_line_size = 64;
+
+    private:
+        struct Cell {
+            std::atomic<size_type> sequence;
+            alignas(T) unsigned char storage[sizeof(T)];
+
+            T* data() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+        };
+
+        Cell* buffer;
+        size_type mask;
+
+        // producers and consumers each hammer their own position, so keep them on separate cache lines
+        alignas(cache_line_size) std::atomic<size_type> tail;
+        alignas(cache_line_size) std::atomic<size_type> head;
+
+        static size_type round_up_to_power_of_two(size_type count) {
+            size_type capacity = 2;
+            while (capacity < count) { capacity <<= 1; }
+            return capacity;
+        }
+
+        // claims up to count consecutive slots with one CAS on position (tail for pushes, head for pops), the first
+        // at pos; a slot at position p is ready when its sequence is p + lag. Returns how many were claimed, 0 when
+        // the first slot is not ready (the queue is full, or empty)
+        size_type claim(std::atomic<size_type>& position, size_type& pos, size_type count, size_type lag) noexcept {
+            if (count == 0) { return 0; }
+
+            pos = position.load(std::memory_order_relaxed);
+
+            while (true) {
+                size_type ready = 0;
+                ptrdiff_t diff = 0;
+                while (ready < count) {
+                    size_type sequence = buffer[(pos + ready) & mask].sequence.load(std::memory_order_acquire);
+                    diff = static_cast<ptrdiff_t>(sequence) - static_cast<ptrdiff_t>(pos + ready + lag);
+                    if (diff != 0) { break; }
+                    ready++;
+                }
+
+                if (ready > 0) {
+                    // a ready slot can only be taken by whoever moves position past it, so if the CAS succeeds
+                    // all of them are still ours
+                    if (position.compare_exchange_weak(pos, pos + ready, std::memory_order_relaxed)) { return ready; }
+                }
+                else if (diff < 0) {
+                    return 0;
+                }
+                else {
+                    pos = position.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        size_type claim_push(size_type& pos, size_type count) noexcept { return claim(tail, pos, count, 0); }
+
+        size_type claim_pop(size_type& pos, size_type count) noexcept { return claim(head, pos, count, 1); }
+
+        // constructs the element in a claimed slot and hands it to consumers; must not throw, since a claimed
+        // slot that is never published stalls every consumer behind it
+        template <typename... Args>
+        void publish(size_type pos, Args&&... args) noexcept {
+            Cell& cell = buffer[pos & mask];
+            ::new (static_cast<void*>(cell.storage)) T(std::forward<Args>(args)...);
+            cell.sequence.store(pos + 1, std::memory_order_release);
+        }
+
+        // moves the element out of a claimed slot and hands the slot back to producers, even if the
+        // assignment throws (the element is then lost)
+        template <typename Out>
+        void consume(size_type pos, Out&& out) {
+            struct Release {
+                Cell& cell;
+                size_type sequence;
+                ~Release() {
+                    cell.data()->~T();
+                    cell.sequence.store(sequence, std::memory_order_release);
+                }
+            } release{buffer[pos & mask], pos + mask + 1};
+
+            out = std::move(*release.cell.data());
+        }
+
+    public:
+        /**
+         * @brief Construct an empty queue holding at least capacity elements (rounded up to a power of two).
+         */
+        explicit RingQueue(size_type capacity = 1024)
+            : buffer(nullptr), mask(round_up_to_power_of_two(capacity) - 1), tail(0), head(0) {
+            buffer = new Cell[mask + 1];
+            for (size_type i = 0; i <= mask; i++) {
+                buffer[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        RingQueue(const RingQueue&) = delete;
+        RingQueue(RingQueue&&) = delete;
+        RingQueue& operator=(const RingQueue&) = delete;
+        RingQueue& operator=(RingQueue&&) = delete;
+
+        // Destructor, must not race with any push or pop
+        ~RingQueue() {
+            size_type last = tail.load(std::memory_order_acquire);
+            for (size_type pos = head.load(std::memory_order_acquire); pos != last; pos++) {
+                buffer[pos & mask].data()->~T();
+            }
+            delete[] buffer;
+        }
+
+        size_type capacity() const noexcept { return mask + 1; }
+
+        /**
+         * @brief Approximate number of elements; exact only while no other thread is pushing or popping.
+         */
+        size_type size() const noexcept {
+            size_type h = head.load(std::memory_order_acquire);
+            size_type t = tail.load(std::memory_order_acquire);
+            return (t > h) ? t - h : 0;
+        }
+
+        bool empty() const noexcept { return size() == 0; }
+
+        /**
+         * @brief Construct an element in place at the back of the queue.
+         * @return false if the queue was full; the arguments are left untouched, unless T's constructor from
+         *         them may throw: it then runs before a slot is claimed (into a temporary that is moved in), and
+         *         rvalue arguments are moved from
+         */
+        template <typename... Args>
+        bool try_emplace(Args&&... args) {
+            if constexpr (std::is_nothrow_constructible<T, Args&&...>::value) {
+                size_type pos;
+                if (claim_push(pos, 1) == 0) { return false; }
+
+                publish(pos, std::forward<Args>(args)...);
+                return true;
+            }
+            else {
+                T value(std::forward<Args>(args)...);
+                return try_emplace(std::move(value));
+            }
+        }
+
+        bool try_push(const value_type& value) { return try_emplace(value); }
+
+        bool try_push(value_type&& value) { return try_emplace(std::move(value)); }
+
+        /**
+         * @brief Move the front element into value.
+         * @return false if the queue was empty
+         */
+        bool try_pop(value_type& value) {
+            size_type pos;
+            if (claim_pop(pos, 1) == 0) { return false; }
+
+            consume(pos, value);
+            return true;
+        }
+
+        /**
+         * @brief Push count elements starting at first, stopping early if the queue fills up. Free slots are
+         *        claimed a run at a time with one CAS; if copying an element may throw, they are pushed one by one.
+         * @return the number of elements pushed (a prefix of the input)
+         */
+        template <typename InputIt>
+        size_type try_push_bulk(InputIt first, size_type count) {
+            size_type pushed = 0;
+
+            if constexpr (std::is_nothrow_constructible<T, decltype(*first)>::value) {
+                size_type pos;
+                while (size_type claimed = claim_push(pos, count - pushed)) {
+                    for (size_type i = 0; i < claimed; ++i, ++first) { publish(pos + i, *first); }
+                    pushed += claimed;
+                }
+            }
+            else {
+                for (; pushed < count; ++pushed, ++first) {
+                    if (!try_push(*first)) { break; }
+                }
+            }
+            return pushed;
+        }
+
+        /**
+         * @brief Pop up to count elements into consecutive positions starting at out. Ready elements are claimed
+         *        a run at a time with one CAS; if assigning to *out may throw, they are popped one by one.
+         * @return the number of elements popped
+         */
+        template <typename OutputIt>
+        size_type try_pop_bulk(OutputIt out, size_type count) {
+            size_type popped = 0;
+
+            if constexpr (std::is_nothrow_assignable<decltype(*out), T&&>::value) {
+                size_type pos;
+                while (size_type claimed = claim_pop(pos, count - popped)) {
+                    for (size_type i = 0; i < claimed; ++i, ++out) { consume(pos + i, *out); }
+                    popped += claimed;
+                }
+            }
+            else {
+                for (; popped < count; ++popped, ++out) {
+                    if (!try_pop(*out)) { break; }
+                }
+            }
+            return popped;
+        }
+};
+
+#endif
@@ -0,0 +1,256 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+template <typename T>
+class BlockingSpscQueue;
+
+// Bounded single-producer/single-consumer queue on a power-of-two ring buffer. Exactly one thread may push
+// and exactly one (other) thread may pop. Both sides are wait-free: each keeps a private copy of the other
+// side's index and only re-reads the shared one when the copy says the queue looks full (or empty), so in the
+// steady state neither side touches the other's cache line.
+template <typename T>
+class SpscQueue {
+
+    friend class BlockingSpscQueue<T>;
+
+    public:
+        using value_type      = T;
+        using size_type       = size_t;
+        using reference       = T&;
+        using const_reference = const T&;
+
+        static constexpr size_type cache_line_size = 64;
+
+    private:
+        struct Slot {
+            alignas(T) unsigned char storage[sizeof(T)];
+
+            T* data() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+        };
+
+        Slot* buffer;
+        size_type mask;
+
+        // producer side: the next index to write and the last head it saw
+        alignas(cache_line_size) std::atomic<size_type> tail;
+        size_type cached_head;
+
+        // consumer side: the next index to read and the last tail it saw
+        alignas(cache_line_size) std::atomic<size_type> head;
+        size_type cached_tail;
+
+        static size_type round_up_to_power_of_two(size_type count) {
+            size_type capacity = 2;
+            while (capacity < count) { capacity <<= 1; }
+            return capacity;
+        }
+
+    public:
+        /**
+         * @brief Construct an empty queue holding at least capacity elements (rounded up to a power of two).
+         */
+        explicit SpscQueue(size_type capacity = 1024)
+            : buffer(new Slot[round_up_to_power_of_two(capacity)]), mask(round_up_to_power_of_two(capacity) - 1),
+              tail(0), cached_head(0), head(0), cached_tail(0) {}
+
+        SpscQueue(const SpscQueue&) = delete;
+        SpscQueue(SpscQueue&&) = delete;
+        SpscQueue& operator=(const SpscQueue&) = delete;
+        SpscQueue& operator=(SpscQueue&&) = delete;
+
+        // Destructor, must not race with the producer or the consumer
+        ~SpscQueue() {
+            size_type last = tail.load(std::memory_order_acquire);
+            for (size_type pos = head.load(std::memory_order_acquire); pos != last; pos++) {
+                buffer[pos & mask].data()->~T();
+            }
+            delete[] buffer;
+        }
+
+        size_type capacity() const noexcept { return mask + 1; }
+
+        /**
+         * @brief Number of elements; exact when called from the producer or the consumer thread.
+         */
+        size_type size() const noexcept {
+            return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+        }
+
+        bool empty() const noexcept { return size() == 0; }
+
+        /**
+         * @brief Construct an element at the back of the queue (producer only).
+         * @return false if the queue was full
+         */
+        template <typename... Args>
+        bool try_emplace(Args&&... args) {
+            size_type pos = tail.load(std::memory_order_relaxed);
+
+            if (pos - cached_head == capacity()) {
+                cached_head = head.load(std::memory_order_acquire);
+                if (pos - cached_head == capacity()) { return false; }
+            }
+
+            ::new (static_cast<void*>(buffer[pos & mask].storage)) T(std::forward<Args>(args)...);
+            tail.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool try_push(const value_type& value) { return try_emplace(value); }
+
+        bool try_push(value_type&& value) { return try_emplace(std::move(value)); }
+
+        /**
+         * @brief Insert element at the back (producer only), spinning while the queue is full.
+         */
+        void push(const value_type& value) { while (!try_emplace(value)) {} }
+
+        void push(value_type&& value) { while (!try_emplace(std::move(value))) {} }
+
+        /**
+         * @brief Return a pointer to the front element, or nullptr if the queue is empty (consumer only).
+         */
+        value_type* peek() noexcept {
+            size_type pos = head.load(std::memory_order_relaxed);
+
+            if (pos == cached_tail) {
+                cached_tail = tail.load(std::memory_order_acquire);
+                if (pos == cached_tail) { return nullptr; }
+            }
+
+            return buffer[pos & mask].data();
+        }
+
+        /**
+         * @brief Return a reference to the front element (consumer only). The queue must not be empty.
+         */
+        reference front() { return *peek(); }
+
+        /**
+         * @brief Remove the front element (consumer only). The queue must not be empty.
+         */
+        void pop() {
+            size_type pos = head.load(std::memory_order_relaxed);
+            buffer[pos & mask].data()->~T();
+            head.store(pos + 1, std::memory_order_release);
+        }
+
+        /**
+         * @brief Move the front element into value and remove it (consumer only).
+         * @return false if the queue was empty
+         */
+        bool try_pop(value_type& value) {
+            value_type* data = peek();
+            if (data == nullptr) { return false; }
+
+            value = std::move(*data);
+            pop();
+            return true;
+        }
+};
+
+// SpscQueue whose push blocks while the queue is full and whose pop blocks while it is empty. A blocked side
+// first spins for spin_limit attempts and then sleeps in std::atomic::wait (a futex on Linux) on the other
+// side's index. The other side only pays for a notify when it sees that someone is actually asleep.
+template <typename T>
+class BlockingSpscQueue {
+    public:
+        using value_type      = T;
+        using size_type       = size_t;
+        using reference       = T&;
+        using const_reference = const T&;
+
+    private:
+        SpscQueue<T> q;
+        size_type spin_limit;
+
+        alignas(SpscQueue<T>::cache_line_size) std::atomic<bool> producer_sleeping;
+        alignas(SpscQueue<T>::cache_line_size) std::atomic<bool> consumer_sleeping;
+
+        // sleeps until index no longer holds observed; the flag tells the other side to notify us. observed must
+        // be the value the failed attempt saw (the cached copy it just refreshed), not a fresh load: an update
+        // landing between the attempt and such a load would go unnoticed by both sides and never be notified
+        static void sleep_on(std::atomic<size_type>& index, size_type observed, std::atomic<bool>& sleeping) {
+            sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            index.wait(observed, std::memory_order_acquire);
+            sleeping.store(false, std::memory_order_relaxed);
+        }
+
+        static void wake(std::atomic<size_type>& index, std::atomic<bool>& sleeping) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (sleeping.load(std::memory_order_relaxed)) { index.notify_one(); }
+        }
+
+    public:
+        explicit BlockingSpscQueue(size_type capacity = 1024, size_type spin_limit = 1024)
+            : q(capacity), spin_limit(spin_limit), producer_sleeping(false), consumer_sleeping(false) {}
+
+        size_type capacity() const noexcept { return q.capacity(); }
+
+        size_type size() const noexcept { return q.size(); }
+
+        bool empty() const noexcept { return q.empty(); }
+
+        bool try_push(const value_type& value) {
+            if (!q.try_push(value)) { return false; }
+            wake(q.tail, consumer_sleeping);
+            return true;
+        }
+
+        bool try_push(value_type&& value) {
+            if (!q.try_push(std::move(value))) { return false; }
+            wake(q.tail, consumer_sleeping);
+            return true;
+        }
+
+        /**
+         * @brief Insert element at the back (producer only), sleeping while the queue is full.
+         */
+        void push(const value_type& value) {
+            for (size_type spins = 0; !q.try_push(value); spins++) {
+                if (spins >= spin_limit) { sleep_on(q.head, q.cached_head, producer_sleeping); }
+            }
+            wake(q.tail, consumer_sleeping);
+        }
+
+        void push(value_type&& value) {
+            for (size_type spins = 0; !q.try_push(std::move(value)); spins++) {
+                if (spins >= spin_limit) { sleep_on(q.head, q.cached_head, producer_sleeping); }
+            }
+            wake(q.tail, consumer_sleeping);
+        }
+
+        /**
+         * @brief Return a reference to the front element (consumer only), sleeping while the queue is empty.
+         */
+        reference front() {
+            value_type* data = q.peek();
+            for (size_type spins = 0; data == nullptr; spins++, data = q.peek()) {
+                if (spins >= spin_limit) { sleep_on(q.tail, q.cached_tail, consumer_sleeping); }
+            }
+            return *data;
+        }
+
+        /**
+         * @brief Remove the front element (consumer only), sleeping until there is one.
+         */
+        void pop() {
+            front();
+            q.pop();
+            wake(q.head, producer_sleeping);
+        }
+
+        bool try_pop(value_type& value) {
+            if (!q.try_pop(value)) { return false; }
+            wake(q.head, producer_sleeping);
+            return true;
+        }
+};
+
+#endif
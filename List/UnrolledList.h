@@ -0,0 +1,379 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Doubly linked list whose nodes each hold up to BlockSize elements in a small inline array.
+// Traversal touches one node per block instead of one per element and the per-element
+// overhead of the two links is amortized over the block. Same interface as List<T>.
+template
+ <class T, size_t BlockSize = ((sizeof(T) < 16) ? 128 / sizeof(T) : 8)>
+class UnrolledList {
+    static_assert(BlockSize >= 2, "BlockSize must hold at least two elements");
+
+    private:
+        // head and tail are sentinels without element storage
+        struct NodeBase {
+            NodeBase* next;
+            NodeBase* prev;
+            size_t count;
+
+            explicit NodeBase(NodeBase* prev = nullptr, NodeBase* next = nullptr)
+            : next{next}, prev{prev}, count{0} {}
+        };
+
+        struct Node : NodeBase {
+            alignas(T) unsigned char storage[BlockSize * sizeof(T)];
+
+            explicit Node(NodeBase* prev = nullptr, NodeBase* next = nullptr)
+            : NodeBase(prev, next) {}
+
+            T* data() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+
+            T& operator[](size_t index) noexcept { return data()[index]; }
+        };
+
+        static Node* block(NodeBase* node) noexcept { return static_cast<Node*>(node); }
+
+    template <typename pointer_type, typename reference_type>
+    class basic_iterator {
+
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type        = T;
+            using difference_type   = ptrdiff_t;
+            using pointer           = pointer_type;
+            using reference         = reference_type;
+
+        private:
+            friend class UnrolledList<value_type, BlockSize>;
+
+            NodeBase* node;
+            size_t index;
+
+            basic_iterator(NodeBase* ptr, size_t index) noexcept : node{ptr}, index{index} {}
+            basic_iterator(const NodeBase* ptr, size_t index) noexcept : node{const_cast<NodeBase*>(ptr)}, index{index} {}
+
+        public:
+            basic_iterator() : node{nullptr}, index{0} {};
+            basic_iterator(const basic_iterator&) = default;
+            basic_iterator(basic_iterator&&) = default;
+            ~basic_iterator() = default;
+            basic_iterator& operator=(const basic_iterator&) = default;
+            basic_iterator& operator=(basic_iterator&&) = default;
+
+            // iterator -> const_iterator
+            operator basic_iterator<const T*, const T&>() const noexcept { return basic_iterator<const T*, const T&>(node, index); }
+
+            reference operator*() const { return (*block(node))[index]; }
+
+            pointer operator->() const { return &(*block(node))[index]; }
+
+            // Prefix Increment: ++a
+            basic_iterator& operator++() {
+                if (++index == node->count) { node = node->next; index = 0; }
+                return *this;
+            }
+
+            // Postfix Increment: a++
+            basic_iterator operator++(int) { basic_iterator result = *this; ++(*this) ; return result; }
+
+            // Prefix Decrement: --a
+            basic_iterator& operator--() {
+                if (index == 0) { node = node->prev; index = node->count; }
+                index--;
+                return *this;
+            }
+
+            // Postfix Decrement: a--
+            basic_iterator operator--(int) { basic_iterator result = *this; --(*this) ; return result; }
+
+            friend bool operator==(const basic_iterator& lhs, const basic_iterator& rhs) noexcept {
+                return lhs.node == rhs.node && lhs.index == rhs.index;
+            }
+
+            friend bool operator!=(const basic_iterator& lhs, const basic_iterator& rhs) noexcept { return !(lhs == rhs); }
+        };
+
+    public:
+        using value_type      = T;
+        using pointer         = value_type*;
+        using const_pointer   = const value_type*;
+        using reference       = value_type&;
+        using const_reference = const value_type&;
+        using iterator        = basic_iterator<pointer, reference>;
+        using const_iterator  = basic_iterator<const_pointer, const_reference>;
+        using size_type       = size_t;
+        using difference_type = ptrdiff_t;
+
+        static constexpr size_type block_size = BlockSize;
+
+    private:
+        NodeBase head, tail;
+        size_type _size;
+
+        // links a new, empty block between before and before->next
+        Node* link_after(NodeBase* before) {
+            Node* node = new Node(before, before->next);
+            before->next->prev = node;
+            before->next = node;
+            return node;
+        }
+
+        void unlink(NodeBase* node) noexcept {
+            node->prev->next = node->next;
+            node->next->prev = node->prev;
+            delete block(node);
+        }
+
+        // moves the upper half of a full block into a new block right after it
+        Node* split(Node* node) {
+            Node* upper = link_after(node);
+            size_t half = node->count / 2;
+
+            for (size_t i = half; i < node->count; i++) {
+                ::new (static_cast<void*>(upper->data() + (i - half))) T(std::move((*node)[i]));
+                (*node)[i].~T();
+            }
+
+            upper->count = node->count - half;
+            node->count = half;
+            return upper;
+        }
+
+        // opens a gap at index (the block must have room) and constructs value there
+        template <typename U>
+        void emplace_in_block(Node* node, size_t index, U&& value) {
+            T* data = node->data();
+
+            if (index == node->count) {
+                ::new (static_cast<void*>(data + index)) T(std::forward<U>(value));
+            }
+            else {
+                ::new (static_cast<void*>(data + node->count)) T(std::move(data[node->count - 1]));
+                for (size_t i = node->count - 1; i > index; i--) {
+                    data[i] = std::move(data[i - 1]);
+                }
+                data[index] = std::forward<U>(value);
+            }
+
+            node->count++;
+            _size++;
+        }
+
+        template <typename U>
+        iterator insert_value(const_iterator pos, U&& value) {
+            NodeBase* node = pos.node;
+            size_t index = pos.index;
+
+            // inserting at the boundary of two blocks: prefer appending to the previous block
+            if (index == 0 && node->prev != &head && node->prev->count < BlockSize) {
+                node = node->prev;
+                index = node->count;
+            }
+            else if (node == &tail) {
+                node = link_after(tail.prev);
+            }
+            else if (node->count == BlockSize) {
+                if (index == 0) {
+                    node = link_after(node->prev);
+                }
+                else {
+                    Node* upper = split(block(node));
+                    if (index >= node->count) {
+                        index -= node->count;
+                        node = upper;
+                    }
+                }
+            }
+
+            emplace_in_block(block(node), index, std::forward<U>(value));
+            return iterator(node, index);
+        }
+
+        // folds a block's successor into it when both together fit in one block
+        void merge_with_next(NodeBase* node) noexcept {
+            NodeBase* next = node->next;
+            if (next == &tail || node->count + next->count > BlockSize) { return; }
+
+            for (size_t i = 0; i < next->count; i++) {
+                ::new (static_cast<void*>(block(node)->data() + node->count + i)) T(std::move((*block(next))[i]));
+                (*block(next))[i].~T();
+            }
+
+            node->count += next->count;
+            next->count = 0;
+            unlink(next);
+        }
+
+    public:
+        UnrolledList() : _size(0) {
+            head.next = &tail;
+            tail.prev = &head;
+        }
+
+        UnrolledList(size_type count, const T& value) : _size(0) {
+            head.next = &tail;
+            tail.prev = &head;
+
+            for (size_t i = 0; i < count; i++) {
+                push_back(value);
+            }
+        }
+
+        explicit UnrolledList(size_type count) : _size(0) {
+            head.next = &tail;
+            tail.prev = &head;
+
+            for (size_t i = 0; i < count; i++) {
+                push_back(T());
+            }
+        }
+
+        // Copy constructor
+        UnrolledList(const UnrolledList& other) : _size(0) {
+            head.next = &tail; tail.prev = &head;
+
+            for (const_iterator it = other.begin(); it != other.end(); it++) {
+                push_back(*it);
+            }
+        }
+
+        // Move constructor
+        UnrolledList(UnrolledList&& other) noexcept : _size(other._size) {
+            head.next = &tail; tail.prev = &head;
+            steal(other);
+        }
+
+        // Copy assignment operator
+        UnrolledList& operator=(const UnrolledList& other) {
+            if (this != &other) {
+                clear();
+
+                for (const_iterator it = other.begin(); it != other.end(); it++) {
+                    push_back(*it);
+                }
+            }
+            return *this;
+        }
+
+        // Move assignment operator
+        UnrolledList& operator=(UnrolledList&& other) noexcept {
+            if (this != &other) {
+                clear();
+                _size = other._size;
+                steal(other);
+            }
+
+            return *this;
+        }
+
+        // Destructor
+        ~UnrolledList() {
+            clear();
+        }
+
+        void clear() noexcept {
+            NodeBase* node = head.next;
+            while (node != &tail) {
+                NodeBase* next = node->next;
+                for (size_t i = 0; i < node->count; i++) { (*block(node))[i].~T(); }
+                delete block(node);
+                node = next;
+            }
+
+            head.next = &tail;
+            tail.prev = &head;
+            _size = 0;
+        }
+
+        reference front() { return (*block(head.next))[0]; }
+
+        const_reference front() const { return (*block(head.next))[0]; }
+
+        reference back() { return (*block(tail.prev))[tail.prev->count - 1]; }
+
+        const_reference back() const { return (*block(tail.prev))[tail.prev->count - 1]; }
+
+
+        iterator begin() noexcept { return iterator(head.next, 0);  }
+
+        const_iterator begin() const noexcept { return const_iterator(head.next, 0); }
+
+        const_iterator cbegin() const noexcept { return const_iterator(head.next, 0); }
+
+        iterator end() noexcept { return iterator(&tail, 0); }
+
+        const_iterator end() const noexcept { return const_iterator(&tail, 0); }
+
+        const_iterator cend() const noexcept { return const_iterator(&tail, 0); }
+
+
+        bool empty() const noexcept { return _size == 0; }
+
+        size_type size() const noexcept { return _size; }
+
+        iterator insert(const_iterator pos, const T& value) { return insert_value(pos, value); }
+
+        iterator insert(const_iterator pos, T&& value) { return insert_value(pos, std::move(value)); }
+
+        iterator erase(const_iterator pos) {
+            NodeBase* node = pos.node;
+            size_t index = pos.index;
+            T* data = block(node)->data();
+
+            for (size_t i = index; i + 1 < node->count; i++) {
+                data[i] = std::move(data[i + 1]);
+            }
+            data[node->count - 1].~T();
+            node->count--;
+            _size--;
+
+            if (node->count == 0) {
+                NodeBase* after = node->next;
+                unlink(node);
+                return iterator(after, 0);
+            }
+
+            if (node->count < BlockSize / 2) { merge_with_next(node); }
+
+            return (index < node->count) ? iterator(node, index) : iterator(node->next, 0);
+        }
+
+        void push_back(const T& value) { insert_value(end(), value); }
+
+        void push_back(T&& value) { insert_value(end(), std::move(value)); }
+
+        void pop_back() {
+            NodeBase* last = tail.prev;
+            (*block(last))[--last->count].~T();
+            if (last->count == 0) { unlink(last); }
+
+            _size--;
+        }
+
+        void push_front(const T& value) { insert_value(begin(), value); }
+
+        void push_front(T&& value) { insert_value(begin(), std::move(value)); }
+
+        void pop_front() { erase(begin()); }
+
+    private:
+        // takes over other's blocks; _size has already been set by the caller
+        void steal(UnrolledList& other) noexcept {
+            if (other._size == 0) { return; }
+
+            head.next = other.head.next;
+            tail.prev = other.tail.prev;
+            head.next->prev = &head;
+            tail.prev->next = &tail;
+
+            other._size = 0;
+
+            other.head.next = &(other.tail);
+            other.tail.prev = &(other.head);
+        }
+};
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Binary max-heap (with respect to Compare) whose elements can be changed or removed after insertion.
+ *        push returns a handle, and a position map from handles to heap slots lets increase_key, decrease_key,
+ *        update and erase find the element in O(1) and restore the heap in O(log n). A handle stays valid until
+ *        its element is popped or erased; after that it may be reused by a later push.
+ *
+ *        "Increase" and "decrease" are meant with respect to Compare: increase_key moves an element towards
+ *        the top. For a min-heap (Compare = std::greater<T>), lowering a distance is therefore increase_key.
+ */
+template <class T, class Compare = std::less<T>>
+class AddressablePriorityQueue {
+public:
+    using value_compare = Compare;
+    using value_type = T;
+    using size_type = size_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using handle_type = size_t;
+
+private:
+    struct Entry {
+        value_type value;
+        handle_type handle;
+    };
+
+    // the heap itself; values sit next to their handles so that sifting compares contiguous memory
+    std::vector<Entry> heap;
+    // position[handle] is the heap slot holding that handle's element
+    std::vector<size_type> position;
+    // handles whose elements were popped or erased, ready for reuse
+    std::vector<handle_type> free_handles;
+
+    value_compare comp;
+
+    size_type parent(size_type index) { return (index - 1) / 2; }
+
+    size_type left_child(size_type index) { return 2 * index + 1; }
+
+    void place(size_type index, Entry&& entry) {
+        position[entry.handle] = index;
+        heap[index] = std::move(entry);
+    }
+
+    /**
+     * @brief Move entry up from the hole at index until its parent is not smaller, then drop it into the hole.
+     */
+    void sift_up(size_type index, Entry entry) {
+        while (index > 0) {
+            size_type parent_index = parent(index);
+            if (!comp(heap[parent_index].value, entry.value)) { break; }
+
+            place(index, std::move(heap[parent_index]));
+            index = parent_index;
+        }
+        place(index, std::move(entry));
+    }
+
+    /**
+     * @brief Move entry down from the hole at index until no child is larger, then drop it into the hole.
+     */
+    void sift_down(size_type index, Entry entry) {
+        size_type n = heap.size();
+        size_type child;
+
+        while ((child = left_child(index)) < n) {
+            if (child + 1 < n) { child += comp(heap[child].value, heap[child + 1].value); }
+            if (!comp(entry.value, heap[child].value)) { break; }
+
+            place(index, std::move(heap[child]));
+            index = child;
+        }
+        place(index, std::move(entry));
+    }
+
+    /**
+     * @brief Put entry into the hole at index and move it whichever way the heap order requires.
+     */
+    void restore(size_type index, Entry entry) {
+        if (index > 0 && comp(heap[parent(index)].value, entry.value)) {
+            sift_up(index, std::move(entry));
+        }
+        else {
+            sift_down(index, std::move(entry));
+        }
+    }
+
+    /**
+     * @brief Take the entry at index out of the heap, filling the hole with the last entry.
+     */
+    void remove_at(size_type index) {
+        free_handles.push_back(heap[index].handle);
+
+        Entry last = std::move(heap.back());
+        heap.pop_back();
+        if (index < heap.size()) { restore(index, std::move(last)); }
+    }
+
+    template <typename U>
+    handle_type insert(U&& value) {
+        handle_type handle;
+        if (free_handles.empty()) {
+            handle = position.size();
+            position.push_back(heap.size());
+        }
+        else {
+            handle = free_handles.back();
+            free_handles.pop_back();
+        }
+
+        heap.push_back(Entry{std::forward<U>(value), handle});
+        sift_up(heap.size() - 1, std::move(heap.back()));
+        return handle;
+    }
+
+public:
+    AddressablePriorityQueue() = default;
+    explicit AddressablePriorityQueue(const Compare& compare) : comp(compare) {}
+    AddressablePriorityQueue(const AddressablePriorityQueue& other) = default;
+    AddressablePriorityQueue(AddressablePriorityQueue&& other) = default;
+    ~AddressablePriorityQueue() = default;
+    AddressablePriorityQueue& operator=(const AddressablePriorityQueue& other) = default;
+    AddressablePriorityQueue& operator=(AddressablePriorityQueue&& other) = default;
+
+    /**
+     * @brief Return a const reference to the element at the top of the heap.
+     * @return const_reference to the element at the top of the heap.
+     */
+    const_reference top() const { return heap.front().value; }
+
+    /**
+     * @brief Return the handle of the element at the top of the heap.
+     * @return handle_type of the top element
+     */
+    handle_type top_handle() const { return heap.front().handle; }
+
+    /**
+     * @brief Return whether the heap is empty.
+     * @return true if there are no elements; false otherwise
+     */
+    bool empty() const { return heap.empty(); }
+
+    /**
+     * @brief Return the number of elements in the heap.
+     * @return size_type of the number of elements in the heap
+     */
+    size_type size() const { return heap.size(); }
+
+    /**
+     * @brief Return the element a (valid) handle refers to.
+     * @param handle returned by push
+     */
+    const_reference get(handle_type handle) const { return heap[position[handle]].value; }
+
+    /**
+     * @brief Insert element into the heap
+     * @param value inserted by copying
+     * @return handle to the inserted element
+     */
+    handle_type push(const value_type& value) { return insert(value); }
+
+    /**
+     * @brief Insert element into the heap
+     * @param value inserted by moving
+     * @return handle to the inserted element
+     */
+    handle_type push(value_type&& value) { return insert(std::move(value)); }
+
+    /**
+     * @brief Remove the top element
+     */
+    void pop() { remove_at(0); }
+
+    /**
+     * @brief Replace the element at handle with value, which must not compare smaller than the current one.
+     *        The element can only move up.
+     */
+    void increase_key(handle_type handle, value_type value) {
+        sift_up(position[handle], Entry{std::move(value), handle});
+    }
+
+    /**
+     * @brief Replace the element at handle with value, which must not compare larger than the current one.
+     *        The element can only move down.
+     */
+    void decrease_key(handle_type handle, value_type value) {
+        sift_down(position[handle], Entry{std::move(value), handle});
+    }
+
+    /**
+     * @brief Replace the element at handle with value, moving it up or down as needed.
+     */
+    void update(handle_type handle, value_type value) {
+        restore(position[handle], Entry{std::move(value), handle});
+    }
+
+    /**
+     * @brief Remove the element at handle from the heap.
+     */
+    void erase(handle_type handle) { remove_at(position[handle]); }
+};
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "PriorityQueue.h"
+
+/**
+ * @brief Relaxed concurrent priority queue (MultiQueue, Rihani, Sanders and Dementiev). It holds
+ *        queues_per_thread * threads ordinary PriorityQueue heaps, each behind its own mutex. push goes to a
+ *        random heap; pop looks at two random heaps and takes the better of their tops. Threads rarely meet on
+ *        the same lock, so throughput scales with the number of threads, at the price that pop returns an element
+ *        close to, but not necessarily, the top (the expected rank error is O(number of heaps)).
+ *        Like PriorityQueue this is a max-heap with respect to Compare.
+ */
+template <class T, class Compare = std::less<T>>
+class MultiQueue {
+public:
+    using value_compare = Compare;
+    using value_type = T;
+    using size_type = size_t;
+    using reference = T&;
+    using const_reference = const T&;
+
+    static constexpr size_type cache_line_size = 64;
+
+private:
+    // one heap and its lock per cache line(s), so that neighbouring heaps do not false-share
+    struct alignas(cache_line_size) Shard {
+        std::mutex lock;
+        PriorityQueue<T, std::vector<T>, Compare> heap;
+    };
+
+    std::unique_ptr<Shard[]> shards;
+    size_type shard_count;
+    std::atomic<size_type> _size;
+
+    value_compare comp;
+
+    // cheap per-thread generator (xorshift64*); a shared generator would itself become the bottleneck
+    static size_type random_index(size_type bound) {
+        thread_local uint64_t state = 0x9E3779B97F4A7C15ull ^ std::hash<std::thread::id>{}(std::this_thread::get_id());
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return static_cast<size_type>(((state * 0x2545F4914F6CDD1Dull) >> 32) % bound);
+    }
+
+    template <typename... Args>
+    void emplace_into_random_shard(Args&&... args) {
+        while (true) {
+            Shard& shard = shards[random_index(shard_count)];
+            std::unique_lock<std::mutex> guard(shard.lock, std::try_to_lock);
+            if (!guard.owns_lock()) { continue; }
+
+            shard.heap.emplace(std::forward<Args>(args)...);
+            _size.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    bool take(Shard& shard, value_type& value) {
+        if (shard.heap.empty()) { return false; }
+
+        value = shard.heap.pop_value();
+        _size.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+public:
+    /**
+     * @brief Construct an empty queue with queues_per_thread * threads internal heaps.
+     * @param threads the number of threads expected to use the queue concurrently
+     * @param queues_per_thread the factor c; 2 to 4 is typical, higher lowers contention but raises the rank error
+     */
+    explicit MultiQueue(size_type threads = std::thread::hardware_concurrency(), size_type queues_per_thread = 2,
+                        const Compare& compare = Compare())
+        : shards(nullptr), shard_count(0), _size(0), comp(compare) {
+        shard_count = ((threads == 0) ? 1 : threads) * ((queues_per_thread == 0) ? 1 : queues_per_thread);
+        if (shard_count < 2) { shard_count = 2; }
+        shards = std::make_unique<Shard[]>(shard_count);
+    }
+
+    MultiQueue(const MultiQueue&) = delete;
+    MultiQueue(MultiQueue&&) = delete;
+    MultiQueue& operator=(const MultiQueue&) = delete;
+    MultiQueue& operator=(MultiQueue&&) = delete;
+    ~MultiQueue() = default;
+
+    /**
+     * @brief Return the number of internal heaps.
+     */
+    size_type queue_count() const { return shard_count; }
+
+    /**
+     * @brief Return the number of elements; only a snapshot while other threads are pushing or popping.
+     */
+    size_type size() const { return _size.load(std::memory_order_relaxed); }
+
+    bool empty() const { return size() == 0; }
+
+    /**
+     * @brief Insert element into a random internal heap
+     * @param value inserted by copying
+     */
+    void push(const value_type& value) { emplace_into_random_shard(value); }
+
+    /**
+     * @brief Insert element into a random internal heap
+     * @param value inserted by moving
+     */
+    void push(value_type&& value) { emplace_into_random_shard(std::move(value)); }
+
+    template <typename... Args>
+    void emplace(Args&&... args) { emplace_into_random_shard(std::forward<Args>(args)...); }
+
+    /**
+     * @brief Remove an element close to the top: the better of the tops of two random heaps.
+     * @param value receives the removed element
+     * @return false if the queue was found empty
+     */
+    bool try_pop(value_type& value) {
+        // random sampling; give up after a while so that an (almost) empty queue does not spin forever
+        for (size_type attempt = 0; attempt < 2 * shard_count; attempt++) {
+            size_type i = random_index(shard_count);
+            size_type j = random_index(shard_count - 1);
+            if (j >= i) { j++; }
+
+            Shard& first = shards[i];
+            Shard& second = shards[j];
+
+            std::unique_lock<std::mutex> first_guard(first.lock, std::try_to_lock);
+            if (!first_guard.owns_lock()) { continue; }
+
+            std::unique_lock<std::mutex> second_guard(second.lock, std::try_to_lock);
+            if (!second_guard.owns_lock() || second.heap.empty()) {
+                if (take(first, value)) { return true; }
+                continue;
+            }
+
+            if (first.heap.empty() || comp(first.heap.top(), second.heap.top())) {
+                return take(second, value);
+            }
+            return take(first, value);
+        }
+
+        // sweep every heap before reporting empty
+        for (size_type i = 0; i < shard_count; i++) {
+            std::lock_guard<std::mutex> guard(shards[i].lock);
+            if (take(shards[i], value)) { return true; }
+        }
+        return false;
+    }
+
+    /**
+     * @brief try_pop that also reports the rank error of the removed element: how many elements left in the queue
+     *        should have come out before it (0 for an exact pop). Meant for measuring the relaxation, not for
+     *        production: it costs O(rank log n), and the count is only exact while no other thread uses the queue.
+     * @param value receives the removed element
+     * @param rank receives its rank error
+     * @return false if the queue was found empty
+     */
+    bool try_pop_with_rank(value_type& value, size_type& rank) {
+        if (!try_pop(value)) { return false; }
+
+        // take every better element off each heap to count it, then put them back
+        rank = 0;
+        std::vector<value_type> better;
+        for (size_type i = 0; i < shard_count; i++) {
+            std::lock_guard<std::mutex> guard(shards[i].lock);
+            auto& heap = shards[i].heap;
+
+            while (!heap.empty() && comp(value, heap.top())) { better.push_back(heap.pop_value()); }
+            rank += better.size();
+            heap.push_range(std::make_move_iterator(better.begin()), std::make_move_iterator(better.end()));
+            better.clear();
+        }
+        return true;
+    }
+};
@@ -0,0 +1,282 @@
+#pragma once
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Pairing heap: a max-heap (with respect to Compare) made of a multiway tree of nodes. push and meld are
+ *        O(1), pop is amortized O(log n), and increase_key (moving an element towards the top, as in
+ *        AddressablePriorityQueue) is cheap: the node's subtree is cut off and linked with the root.
+ *        push returns a handle to the node, which stays valid until that element is popped.
+ */
+template <class T, class Compare = std::less<T>>
+class PairingHeap {
+    struct Node {
+        T value;
+        Node* child;
+        Node* sibling;
+        // the previous sibling, or the parent for the leftmost child
+        Node* prev;
+
+        explicit Node(const T& value) : value{value}, child{nullptr}, sibling{nullptr}, prev{nullptr} {}
+
+        explicit Node(T&& value) : value{std::move(value)}, child{nullptr}, sibling{nullptr}, prev{nullptr} {}
+    };
+
+public:
+    using value_compare = Compare;
+    using value_type = T;
+    using size_type = size_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using handle_type = Node*;
+
+private:
+    Node* root;
+    size_type _size;
+
+    value_compare comp;
+
+    /**
+     * @brief Make the smaller of two roots the leftmost child of the larger one.
+     * @return the new root
+     */
+    Node* link(Node* a, Node* b) {
+        if (a == nullptr) { return b; }
+        if (b == nullptr) { return a; }
+
+        if (comp(a->value, b->value)) { std::swap(a, b); }
+
+        b->prev = a;
+        b->sibling = a->child;
+        if (a->child != nullptr) { a->child->prev = b; }
+        a->child = b;
+        a->sibling = nullptr;
+        a->prev = nullptr;
+        return a;
+    }
+
+    /**
+     * @brief Two-pass pairing of a list of siblings: link them in pairs left to right, then fold the pairs
+     *        right to left. The pairs are chained through sibling so no recursion or extra memory is needed.
+     */
+    Node* combine(Node* first) {
+        if (first == nullptr) { return nullptr; }
+
+        Node* pairs = nullptr;
+        while (first != nullptr) {
+            Node* a = first;
+            Node* b = a->sibling;
+            first = (b != nullptr) ? b->sibling : nullptr;
+
+            a->sibling = nullptr;
+            if (b != nullptr) { b->sibling = nullptr; }
+
+            Node* pair = link(a, b);
+            pair->sibling = pairs;
+            pairs = pair;
+        }
+
+        Node* result = pairs;
+        pairs = pairs->sibling;
+        result->sibling = nullptr;
+
+        while (pairs != nullptr) {
+            Node* next = pairs->sibling;
+            pairs->sibling = nullptr;
+            result = link(result, pairs);
+            pairs = next;
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Unlink node (not the root) together with its subtree from its parent's child list.
+     */
+    void cut(Node* node) {
+        if (node->prev->child == node) {
+            node->prev->child = node->sibling;
+        }
+        else {
+            node->prev->sibling = node->sibling;
+        }
+
+        if (node->sibling != nullptr) { node->sibling->prev = node->prev; }
+
+        node->sibling = nullptr;
+        node->prev = nullptr;
+    }
+
+    static void destroy(Node* node) {
+        // iterative, so that a degenerate (path-shaped) heap cannot overflow the stack
+        std::vector<Node*> stack;
+        if (node != nullptr) { stack.push_back(node); }
+
+        while (!stack.empty()) {
+            Node* current = stack.back();
+            stack.pop_back();
+            if (current->child != nullptr) { stack.push_back(current->child); }
+            if (current->sibling != nullptr) { stack.push_back(current->sibling); }
+            delete current;
+        }
+    }
+
+    static Node* copy(const Node* node) {
+        if (node == nullptr) { return nullptr; }
+
+        // pairs of (source, copy) whose children and siblings still need copying
+        std::vector<std::pair<const Node*, Node*>> stack;
+        Node* result = new Node(node->value);
+        stack.emplace_back(node, result);
+
+        while (!stack.empty()) {
+            auto [source, target] = stack.back();
+            stack.pop_back();
+
+            if (source->child != nullptr) {
+                target->child = new Node(source->child->value);
+                target->child->prev = target;
+                stack.emplace_back(source->child, target->child);
+            }
+            if (source->sibling != nullptr) {
+                target->sibling = new Node(source->sibling->value);
+                target->sibling->prev = target;
+                stack.emplace_back(source->sibling, target->sibling);
+            }
+        }
+
+        return result;
+    }
+
+public:
+    PairingHeap() : root(nullptr), _size(0), comp(Compare{}) {}
+
+    explicit PairingHeap(const Compare& compare) : root(nullptr), _size(0), comp(compare) {}
+
+    // Copy constructor; handles into other do not carry over
+    PairingHeap(const PairingHeap& other) : root(copy(other.root)), _size(other._size), comp(other.comp) {}
+
+    // Move constructor
+    PairingHeap(PairingHeap&& other) noexcept : root(other.root), _size(other._size), comp(std::move(other.comp)) {
+        other.root = nullptr;
+        other._size = 0;
+    }
+
+    // Copy assignment operator
+    PairingHeap& operator=(const PairingHeap& other) {
+        if (this != &other) {
+            PairingHeap temp(other);
+            swap(temp);
+        }
+        return *this;
+    }
+
+    // Move assignment operator
+    PairingHeap& operator=(PairingHeap&& other) noexcept {
+        if (this != &other) {
+            clear();
+            swap(other);
+        }
+        return *this;
+    }
+
+    // Destructor
+    ~PairingHeap() {
+        destroy(root);
+    }
+
+    void swap(PairingHeap& other) noexcept {
+        std::swap(root, other.root);
+        std::swap(_size, other._size);
+        std::swap(comp, other.comp);
+    }
+
+    void clear() {
+        destroy(root);
+        root = nullptr;
+        _size = 0;
+    }
+
+    /**
+     * @brief Return a const reference to the element at the top of the heap.
+     * @return const_reference to the element at the top of the heap.
+     */
+    const_reference top() const { return root->value; }
+
+    /**
+     * @brief Return whether the heap is empty.
+     * @return true if there are no elements; false otherwise
+     */
+    bool empty() const { return _size == 0; }
+
+    /**
+     * @brief Return the number of elements in the heap.
+     * @return size_type of the number of elements in the heap
+     */
+    size_type size() const { return _size; }
+
+    /**
+     * @brief Return the element a (valid) handle refers to.
+     */
+    const_reference get(handle_type handle) const { return handle->value; }
+
+    /**
+     * @brief Insert element in O(1)
+     * @param value inserted by copying
+     * @return handle to the inserted element
+     */
+    handle_type push(const value_type& value) {
+        Node* node = new Node(value);
+        root = link(root, node);
+        _size++;
+        return node;
+    }
+
+    /**
+     * @brief Insert element in O(1)
+     * @param value inserted by moving
+     * @return handle to the inserted element
+     */
+    handle_type push(value_type&& value) {
+        Node* node = new Node(std::move(value));
+        root = link(root, node);
+        _size++;
+        return node;
+    }
+
+    /**
+     * @brief Remove the top element
+     */
+    void pop() {
+        Node* old = root;
+        root = combine(root->child);
+        if (root != nullptr) { root->prev = nullptr; }
+        delete old;
+        _size--;
+    }
+
+    /**
+     * @brief Replace the element at handle with value, which must not compare smaller than the current one.
+     */
+    void increase_key(handle_type handle, value_type value) {
+        handle->value = std::move(value);
+        if (handle == root) { return; }
+
+        cut(handle);
+        root = link(root, handle);
+    }
+
+    /**
+     * @brief Move all of other's elements into this heap in O(1); other is left empty. Handles into other stay valid.
+     */
+    void meld(PairingHeap&& other) {
+        if (this == &other) { return; }
+
+        root = link(root, other.root);
+        _size += other._size;
+        other.root = nullptr;
+        other._size = 0;
+    }
+};
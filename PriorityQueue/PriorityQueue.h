@@ -1,11 +1,24 @@
 #pragma once
 
+#include <algorithm>
+#include <bit>
 #include <functional>
+#include <iterator>
 #include <utility>
 #include <vector>
 
-template <class T, class Container = std::vector<T>, class Compare = std::less<T>>
+/**
+ * @brief Max-heap (with respect to Compare) stored in Container.
+ * @tparam Arity number of children per node (2, 4, 8, ...). A wider heap is shallower, and downheap scans each
+ *         group of siblings in contiguous memory. For Arity > 2 the container starts with Arity - 1 unused slots,
+ *         so every sibling group begins at a multiple of Arity. With Arity * sizeof(T) equal to the cache line size
+ *         and a cache-line aligned container (e.g. std::vector<T, AlignedAllocator<T>>), each group is exactly one
+ *         cache line. The padding requires T to be default constructible.
+ */
+template <class T, class Container = std::vector<T>, class Compare = std::less<T>, size_t Arity = 2>
 class PriorityQueue {
+    static_assert(Arity >= 2, "a heap node needs at least two children");
+
 public:
     using value_compare = Compare;
     using value_type = T;
@@ -13,68 +26,216 @@ public:
     using reference = T&;
     using const_reference = const T&;
 
+    static constexpr size_type arity = Arity;
+
 private:
+    // heap index i lives at c[i + offset]
+    static constexpr size_type offset = (Arity == 2) ? 0 : Arity - 1;
+
     Container c;
 
     value_compare comp;
 
-    size_type parent(size_type index) { return (index - 1) / 2; }
+    size_type parent(size_type index) { return (index - 1) / Arity; }
 
-    size_type left_child(size_type index) { return 2 * index + 1; }
+    size_type first_child(size_type index) { return Arity * index + 1; }
 
-    size_type right_child(size_type index) { return 2 * (index + 1); }
+    size_type count() const { return (c.size() > offset) ? c.size() - offset : 0; }
 
-    bool is_internal(size_t index) { return left_child(index) < c.size(); }
+    reference at(size_type index) { return c[index + offset]; }
 
-    bool is_leaf(size_t index) { return left_child(index) >= c.size(); }
+    bool is_internal(size_t index) { return first_child(index) < count(); }
+
+    bool is_leaf(size_t index) { return first_child(index) >= count(); }
 
-    
     /**
-     * @brief Recursively (or Iteratively) swap the value at index up the heap until it is in the correct position.
-     * @param index the current position to swap upwards
+     * @brief Return the index of the largest of the siblings first, ..., first + group - 1. The comparisons
+     *        feed a conditional move rather than a branch.
      */
-    void upheap(size_type index) {
-        reference parent_val = c[parent(index)];
-        reference val = c[index];
+    size_type max_child(size_type first, size_type group) {
+        size_type best = first;
+        for (size_type i = 1; i < group; i++) {
+            best = comp(at(best), at(first + i)) ? first + i : best;
+        }
+        return best;
+    }
+
+    /**
+     * @brief Append the element to c, adding the alignment padding first if c is still empty.
+     */
+    template <typename... Args>
+    void append(Args&&... args) {
+        pad();
+        c.emplace_back(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Add the alignment padding to c if it does not have it yet (c holds no elements then).
+     */
+    void pad() {
+        if constexpr (offset > 0) {
+            if (c.size() < offset) { c.resize(offset); }
+        }
+    }
+
+    /**
+     * @brief Put the alignment padding in front of elements that c was handed without it.
+     */
+    void pad_front() {
+        if constexpr (offset > 0) {
+            // default-construct the slots at the back, then rotate them to the front
+            size_type size = c.size();
+            c.resize(size + offset);
+            std::rotate(c.begin(), c.begin() + size, c.end());
+        }
+    }
+
+    /**
+     * @brief Restore the heap order over the whole container bottom-up (Floyd's method) in O(n):
+     *        sift down every internal node, starting from the last one.
+     */
+    void heapify() {
+        size_type n = count();
+        if (n < 2) { return; }
+
+        for (size_type index = parent(n - 1) + 1; index-- > 0; ) {
+            downheap(index);
+        }
+    }
+
+    /**
+     * @brief The elements from index old_size on were just appended; restore the heap order either by sifting
+     *        each of them up or, when that could cost more, by heapifying everything.
+     */
+    void restore_after_append(size_type old_size) {
+        size_type n = count();
+        size_type added = n - old_size;
 
-        if (index > 0 and comp(parent_val, val)) {
-            std::swap(parent_val, val);
-            upheap(parent(index));
+        // k sift-ups cost up to k * log(n) comparisons, a rebuild about 2n
+        if (added * std::bit_width(n) > 2 * n) {
+            heapify();
+        }
+        else {
+            for (size_type index = old_size; index < n; index++) { upheap(index); }
         }
     }
     
     /**
-     * @brief Recursively swap the value at index down the heap until it is in the correct position.
-     * @param index the current position to swap downwards
+     * @brief Move value up from the hole at index until its parent is not smaller, then drop it into the hole.
+     *        Each level costs one move instead of a swap, and index 0 never reads a parent.
+     * @param index the position of the hole
+     * @param value the element to place
+     */
+    void sift_up(size_type index, value_type value) {
+        while (index > 0) {
+            size_type parent_index = parent(index);
+            if (!comp(at(parent_index), value)) { break; }
+
+            at(index) = std::move(at(parent_index));
+            index = parent_index;
+        }
+        at(index) = std::move(value);
+    }
+
+    /**
+     * @brief Iteratively move the value at index up the heap until it is in the correct position.
+     * @param index the current position to move upwards
+     */
+    void upheap(size_type index) {
+        sift_up(index, std::move(at(index)));
+    }
+
+    /**
+     * @brief Iteratively move the value at index down the heap until it is in the correct position.
+     *        Full sibling groups are scanned without branching; only the last internal node can have
+     *        a partial group, and it is handled once after the loop.
+     * @param index the current position to move downwards
      */
     void downheap(size_type index) {
         if (is_leaf(index)) { return; }
 
-        size_type max_child_index;
+        size_type n = count();
+        value_type value = std::move(at(index));
+        size_type child;
 
-        if (right_child(index) < c.size()) {
-            if (comp(c[right_child(index)], c[left_child(index)])) {
-                max_child_index = left_child(index);
-            }
-            else {
-                max_child_index = right_child(index);
-            }
+        while ((child = first_child(index)) + Arity <= n) {
+            child = max_child(child, Arity);
+            if (!comp(value, at(child))) { at(index) = std::move(value); return; }
+
+            at(index) = std::move(at(child));
+            index = child;
         }
-        else {
-            max_child_index = left_child(index);
+
+        child = first_child(index);
+        if (child < n) {
+            child = max_child(child, n - child);
+            if (comp(value, at(child))) {
+                at(index) = std::move(at(child));
+                index = child;
+            }
         }
+        at(index) = std::move(value);
+    }
+
+    /**
+     * @brief Bottom-up ("Floyd") removal of the top: walk the hole left at the root down to a leaf along the
+     *        larger children, put the last element there and sift it up. The last element nearly always belongs
+     *        near the bottom, so this saves the comparison against it on every level on the way down.
+     */
+    void pop_bottom_up() {
+        size_type n = count() - 1;
+        if (n == 0) { c.pop_back(); return; }
+
+        value_type last = std::move(c.back());
+        c.pop_back();
+
+        size_type index = 0;
+        size_type child;
 
-        reference val = c[index];
-        reference child_val = c[max_child_index];
+        while ((child = first_child(index)) + Arity <= n) {
+            child = max_child(child, Arity);
+            at(index) = std::move(at(child));
+            index = child;
+        }
 
-        if (comp(val, child_val)) {
-            std::swap(val, child_val);
-            downheap(max_child_index);
+        child = first_child(index);
+        if (child < n) {
+            child = max_child(child, n - child);
+            at(index) = std::move(at(child));
+            index = child;
         }
+
+        sift_up(index, std::move(last));
     }
 
 public:
     PriorityQueue() = default;
+
+    explicit PriorityQueue(const Compare& compare) : c(), comp(compare) {}
+
+    /**
+     * @brief Build a heap from the elements of container in O(n).
+     */
+    explicit PriorityQueue(const Container& container, const Compare& compare = Compare()) : c(container), comp(compare) {
+        pad_front();
+        heapify();
+    }
+
+    explicit PriorityQueue(Container&& container, const Compare& compare = Compare()) : c(std::move(container)), comp(compare) {
+        pad_front();
+        heapify();
+    }
+
+    /**
+     * @brief Build a heap from the elements in [first, last) in O(n).
+     */
+    template <typename InputIt>
+    PriorityQueue(InputIt first, InputIt last, const Compare& compare = Compare()) : c(), comp(compare) {
+        pad();
+        c.insert(c.end(), first, last);
+        heapify();
+    }
+
     PriorityQueue(const PriorityQueue& other) = default;
     PriorityQueue(PriorityQueue&& other) = default;
     ~PriorityQueue() = default;
@@ -85,27 +246,27 @@ public:
      * @brief Return a const reference to the element at the top of the heap.
      * @return const_reference to the element at the top of the heap.
      */
-    const_reference top() const { return c.front(); }
+    const_reference top() const { return c[offset]; }
 
     /**
-     * @brief Return whether the heap is empty. This is the same as whether the underlying container, c, is empty.
+     * @brief Return whether the heap is empty, i.e. whether the underlying container, c, holds no elements past the padding.
      * @return true c is empty; false otherwise
      */
-    bool empty() const { return c.empty(); }
+    bool empty() const { return count() == 0; }
 
     /**
-     * @brief Return the number of elements in the heap. This is the same as the number of elements in the underlying container, c.
+     * @brief Return the number of elements in the heap, i.e. the number of elements in the underlying container, c, past the padding.
      * @return size_type of the number of elements in the heap
      */
-    size_type size() const { return c.size(); }
+    size_type size() const { return count(); }
 	
     /**
      * @brief Insert element and sorts the underlying container, c;
      * @param value inserted by copying into c 
      */
     void push(const value_type& value) {
-        c.push_back(value);
-        upheap(c.size() - 1);
+        append(value);
+        upheap(count() - 1);
     }
 
     /**
@@ -113,16 +274,62 @@ public:
      * @param value inserted by moving into c 
      */
 	void push(value_type&& value) {
-        c.push_back(std::move(value));
-        upheap(c.size() - 1);
+        append(std::move(value));
+        upheap(count() - 1);
+    }
+
+    /**
+     * @brief Construct an element in place and sort it into the underlying container, c
+     * @param args forwarded to the constructor of value_type
+     */
+    template <typename... Args>
+    void emplace(Args&&... args) {
+        append(std::forward<Args>(args)...);
+        upheap(count() - 1);
+    }
+
+    /**
+     * @brief Insert the elements in [first, last). They are appended first; the heap is then rebuilt in O(n)
+     *        if the batch is large compared to the heap, and otherwise each new element is sifted up.
+     */
+    template <typename InputIt>
+    void push_range(InputIt first, InputIt last) {
+        size_type old_size = count();
+        pad();
+        c.insert(c.end(), first, last);
+        restore_after_append(old_size);
+    }
+
+    /**
+     * @brief Move all of other's elements into this heap; other is left empty.
+     */
+    void merge(PriorityQueue&& other) {
+        if (this == &other || other.empty()) { return; }
+
+        // append the smaller heap to the larger one
+        pad();
+        if (count() < other.count()) {
+            std::swap(c, other.c);
+        }
+
+        push_range(std::make_move_iterator(other.c.begin() + offset), std::make_move_iterator(other.c.end()));
+        other.c.clear();
     }
 
     /**
      * @brief Remove the top element
      */
     void pop() {
-        c.front() = std::move(c.back()); 
-        c.pop_back();
-        downheap(0);
+        pop_bottom_up();
+    }
+
+    /**
+     * @brief Remove the top element and return it, moved rather than copied out of the heap
+     * @return value_type the former top element
+     */
+    value_type pop_value() {
+        value_type result = std::move(at(0));
+        pop_bottom_up();
+        return result;
     }
 };
\ No newline at end of file
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Monotone radix heap: a min-heap over unsigned integer keys for workloads where a pushed key is never
+ *        smaller than the current minimum (Dijkstra distances, timer deadlines). Elements sit in one bucket per
+ *        bit position of (key XOR minimum key), so push is O(1) and each element is moved between buckets at
+ *        most once per bit of Key, with no comparisons beyond finding the minimum of a bucket being split.
+ *        The top element is the one with the smallest key; elements are (key, value) pairs.
+ */
+template <class Key, class Value>
+class RadixHeap {
+    static_assert(std::is_unsigned<Key>::value, "RadixHeap keys must be unsigned integers");
+
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<Key, Value>;
+    using size_type = std::size_t;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+
+private:
+    static constexpr size_type bucket_count = std::numeric_limits<Key>::digits + 1;
+
+    // last is the key most recently returned by top() or pop(). Bucket 0 holds keys equal to last; bucket i
+    // holds keys whose highest bit differing from last is bit i - 1. Bucket 0 is only refilled when top() or
+    // pop() need an element, so pushes between extractions are measured against the last extracted key
+    mutable std::vector<value_type> buckets[bucket_count];
+    mutable key_type last;
+    size_type _size;
+
+    static size_type bucket_of(key_type key, key_type last) {
+        return static_cast<size_type>(std::bit_width(static_cast<key_type>(key ^ last)));
+    }
+
+    /**
+     * @brief Refill the empty bucket 0: advance last to the minimum key of the first non-empty bucket and
+     *        redistribute that bucket, which sends every element of it to a strictly lower bucket.
+     */
+    void pull() const {
+        size_type i = 1;
+        while (buckets[i].empty()) { i++; }
+
+        key_type minimum = buckets[i].front().first;
+        for (const value_type& element : buckets[i]) {
+            if (element.first < minimum) { minimum = element.first; }
+        }
+
+        last = minimum;
+        for (value_type& element : buckets[i]) {
+            buckets[bucket_of(element.first, last)].push_back(std::move(element));
+        }
+        buckets[i].clear();
+    }
+
+public:
+    RadixHeap() : last(0), _size(0) {}
+
+    /**
+     * @brief Return a const reference to the element with the smallest key; its key becomes min_key().
+     * @return const_reference to the element at the top of the heap.
+     */
+    const_reference top() const {
+        if (buckets[0].empty()) { pull(); }
+        return buckets[0].back();
+    }
+
+    /**
+     * @brief Return whether the heap is empty.
+     * @return true if there are no elements; false otherwise
+     */
+    bool empty() const { return _size == 0; }
+
+    /**
+     * @brief Return the number of elements in the heap.
+     * @return size_type of the number of elements in the heap
+     */
+    size_type size() const { return _size; }
+
+    /**
+     * @brief Return the key last returned by top() or pop() (0 before any); pushed keys must not be smaller.
+     */
+    key_type min_key() const { return last; }
+
+    /**
+     * @brief Insert element in O(1). element.first must not be smaller than min_key().
+     * @param element inserted by copying
+     */
+    void push(const value_type& element) {
+        buckets[bucket_of(element.first, last)].push_back(element);
+        _size++;
+    }
+
+    /**
+     * @brief Insert element in O(1). element.first must not be smaller than min_key().
+     * @param element inserted by moving
+     */
+    void push(value_type&& element) {
+        size_type bucket = bucket_of(element.first, last);
+        buckets[bucket].push_back(std::move(element));
+        _size++;
+    }
+
+    void push(key_type key, const mapped_type& value) { push(value_type(key, value)); }
+
+    void push(key_type key, mapped_type&& value) { push(value_type(key, std::move(value))); }
+
+    /**
+     * @brief Remove the element with the smallest key
+     */
+    void pop() {
+        if (buckets[0].empty()) { pull(); }
+        buckets[0].pop_back();
+        _size--;
+    }
+
+    void clear() {
+        for (auto& bucket : buckets) { bucket.clear(); }
+        last = 0;
+        _size = 0;
+    }
+};
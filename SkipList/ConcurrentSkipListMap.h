@@ -0,0 +1,398 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional> // std::less
+#include <iterator>
+#include <new>
+#include <thread>
+#include <utility> // std::pair
+
+#include "EpochReclamation.h"
+
+/**
+ * @brief Lock-free ordered map: a skip list (Herlihy and Shavit's lock-free variant of Pugh's skip list) whose
+ *        insert, erase, find and contains run concurrently from any number of threads without locks. The key
+ *        order lives in the bottom list; the upper levels are shortcuts. erase first marks a node's links, which
+ *        deletes it logically, and any thread that walks past a marked node unlinks it. Unlinked nodes are
+ *        handed to epoch reclamation (EpochReclamation.h), so readers never touch freed memory.
+ *
+ *        Same template surface as BinarySearchTree, with two differences forced by concurrency: insert does not
+ *        overwrite the value of an existing key (it returns false), and find copies the value out, since a
+ *        reference could outlive the node. Iteration is in key order and weakly consistent: it sees every pair
+ *        present for the whole scan and may or may not see concurrent changes. An iterator holds an epoch guard,
+ *        so it must stay on the thread that created it, and a long-lived iterator delays reclamation.
+ */
+template <typename K, typename V, typename Comparator = std::less<K>>
+class ConcurrentSkipListMap {
+
+    public:
+        using key_type        = K;
+        using value_type      = V;
+        using pair            = std::pair<key_type, value_type>;
+        using const_pointer   = const pair*;
+        using const_reference = const pair&;
+        using size_type       = size_t;
+        using difference_type = ptrdiff_t;
+
+        static constexpr int max_height = 32;
+
+    private:
+        // a successor pointer whose lowest bit marks the owning node as deleted
+        using Link = std::atomic<uintptr_t>;
+
+        static constexpr uintptr_t mark = 1;
+
+        struct alignas(Link) Node {
+            pair element;
+            int height;
+            // the inserter and the eraser each hold one reference; whoever drops the last retires the node
+            std::atomic<int> references;
+
+            template <typename P>
+            Node(P && x, int height) : element{std::forward<P>(x)}, height{height}, references{2} {}
+
+            // the height links are laid out right after the node
+            Link& next(int level) { return reinterpret_cast<Link*>(this + 1)[level]; }
+        };
+
+        static Node* target(uintptr_t link) { return reinterpret_cast<Node*>(link & ~mark); }
+
+        static bool marked(uintptr_t link) { return (link & mark) != 0; }
+
+        static uintptr_t to_link(Node* node) { return reinterpret_cast<uintptr_t>(node); }
+
+        template <typename P>
+        static Node* create(P && x, int height) {
+            void* memory = ::operator new(sizeof(Node) + height * sizeof(Link));
+            Node* node = new (memory) Node(std::forward<P>(x), height);
+            for (int level = 0; level < height; level++) { new (&node->next(level)) Link(0); }
+            return node;
+        }
+
+        static void destroy(Node* node) {
+            node->~Node();
+            ::operator delete(node);
+        }
+
+        static void destroy_erased(void* node) { destroy(static_cast<Node*>(node)); }
+
+    public:
+    class const_iterator {
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = pair;
+            using difference_type   = ptrdiff_t;
+            using pointer           = const pair*;
+            using reference         = const pair&;
+
+        private:
+            friend class ConcurrentSkipListMap;
+
+            Node* node;
+            EpochGuard guard;
+
+            const_iterator(Node* node, EpochGuard guard) : node{node}, guard{std::move(guard)} {}
+
+        public:
+            const_iterator() : node{nullptr}, guard{nullptr} {}
+
+            reference operator*() const { return node->element; }
+
+            pointer operator->() const { return &(node->element); }
+
+            // Prefix Increment: ++a
+            const_iterator& operator++() {
+                node = first_live(target(node->next(0).load(std::memory_order_acquire)));
+                return *this;
+            }
+
+            // Postfix Increment: a++
+            const_iterator operator++(int) { const_iterator result = *this; ++(*this) ; return result; }
+
+            friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) noexcept { return lhs.node == rhs.node; }
+
+            friend bool operator!=(const const_iterator& lhs, const const_iterator& rhs) noexcept { return !(lhs == rhs); }
+    };
+
+        using iterator = const_iterator;
+
+    private:
+        // links of the head sentinel, one per level
+        Link head[max_height];
+        std::atomic<size_type> _size;
+        Comparator comp;
+
+        Link& link(Node* predecessor, int level) { return (predecessor == nullptr) ? head[level] : predecessor->next(level); }
+
+        const Link& link(const Node* predecessor, int level) const {
+            return (predecessor == nullptr) ? head[level] : const_cast<Node*>(predecessor)->next(level);
+        }
+
+        // the first node from node on (in the bottom list) that is not deleted
+        static Node* first_live(Node* node) {
+            while (node != nullptr) {
+                uintptr_t next = node->next(0).load(std::memory_order_acquire);
+                if (!marked(next)) { break; }
+                node = target(next);
+            }
+            return node;
+        }
+
+        // heights follow a geometric distribution with p = 1/2, drawn from a cheap per-thread generator
+        static int random_height() {
+            thread_local uint64_t state = 0x9E3779B97F4A7C15ull ^ std::hash<std::thread::id>{}(std::this_thread::get_id());
+            state ^= state >> 12;
+            state ^= state << 25;
+            state ^= state >> 27;
+            uint64_t bits = state * 0x2545F4914F6CDD1Dull;
+            return 1 + std::countr_zero(bits | (uint64_t(1) << (max_height - 1)));
+        }
+
+        /**
+         * @brief Find, on every level, the last node with a key less than key (predecessors, nullptr for the head)
+         *        and the node after it (successors), unlinking marked nodes on the way.
+         * @return whether successors[0] holds key
+         */
+        bool search(const key_type & key, Node** predecessors, Node** successors) {
+            while (!try_search(key, predecessors, successors)) {}
+            return successors[0] != nullptr && !comp(key, successors[0]->element.first);
+        }
+
+        // one pass of search; false if unlinking a marked node lost a race, in which case the pass starts over
+        bool try_search(const key_type & key, Node** predecessors, Node** successors) {
+            Node* predecessor = nullptr;
+
+            for (int level = max_height - 1; level >= 0; level--) {
+                Node* current = target(link(predecessor, level).load(std::memory_order_acquire));
+
+                while (current != nullptr) {
+                    uintptr_t next = current->next(level).load(std::memory_order_acquire);
+
+                    if (marked(next)) {
+                        uintptr_t expected = to_link(current);
+                        if (!link(predecessor, level).compare_exchange_strong(expected, next & ~mark, std::memory_order_acq_rel)) {
+                            return false;
+                        }
+                        current = target(next);
+                    }
+                    else if (comp(current->element.first, key)) {
+                        predecessor = current;
+                        current = target(next);
+                    }
+                    else {
+                        break;
+                    }
+                }
+
+                predecessors[level] = predecessor;
+                successors[level] = current;
+            }
+
+            return true;
+        }
+
+        // read-only descent: the first live node whose key is not less than key, or nullptr
+        Node* lower_bound_node(const key_type & key) const {
+            const Node* predecessor = nullptr;
+            Node* current = nullptr;
+
+            for (int level = max_height - 1; level >= 0; level--) {
+                current = target(link(predecessor, level).load(std::memory_order_acquire));
+
+                while (current != nullptr) {
+                    uintptr_t next = current->next(level).load(std::memory_order_acquire);
+                    if (marked(next)) {
+                        current = target(next);
+                    }
+                    else if (comp(current->element.first, key)) {
+                        predecessor = current;
+                        current = target(next);
+                    }
+                    else {
+                        break;
+                    }
+                }
+            }
+
+            return current;
+        }
+
+        // drop one of the node's two references, retiring it when both are gone
+        void release(Node* node, EpochGuard & guard) {
+            if (node->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                guard.retire(node, &destroy_erased);
+            }
+        }
+
+        // link the levels above the bottom one, bottom up; stop as soon as the node is being erased
+        void link_shortcuts(Node* node, int height, Node** predecessors, Node** successors) {
+            const key_type & key = node->element.first;
+
+            for (int level = 1; level < height; level++) {
+                while (true) {
+                    uintptr_t next = node->next(level).load(std::memory_order_acquire);
+                    if (marked(next)) { return; }
+
+                    if (target(next) != successors[level] &&
+                        !node->next(level).compare_exchange_strong(next, to_link(successors[level]), std::memory_order_acq_rel)) {
+                        continue;
+                    }
+
+                    uintptr_t expected = to_link(successors[level]);
+                    if (link(predecessors[level], level).compare_exchange_strong(expected, to_link(node), std::memory_order_acq_rel)) {
+                        break;
+                    }
+
+                    // the neighbourhood changed; look again, unless the node is already gone
+                    if (!search(key, predecessors, successors) || successors[0] != node) { return; }
+                }
+            }
+        }
+
+        template <typename P>
+        bool insert_pair(P && x) {
+            EpochGuard guard;
+            Node* predecessors[max_height];
+            Node* successors[max_height];
+
+            if (search(x.first, predecessors, successors)) { return false; }
+
+            int height = random_height();
+            Node* node = create(std::forward<P>(x), height);
+            const key_type & key = node->element.first;
+
+            // linking into the bottom list is what makes the node present
+            while (true) {
+                for (int level = 0; level < height; level++) {
+                    node->next(level).store(to_link(successors[level]), std::memory_order_relaxed);
+                }
+
+                uintptr_t expected = to_link(successors[0]);
+                if (link(predecessors[0], 0).compare_exchange_strong(expected, to_link(node), std::memory_order_acq_rel)) {
+                    break;
+                }
+
+                if (search(key, predecessors, successors)) {
+                    destroy(node);
+                    return false;
+                }
+            }
+
+            _size.fetch_add(1, std::memory_order_relaxed);
+
+            link_shortcuts(node, height, predecessors, successors);
+
+            // an eraser may have finished before a late shortcut went in; unlink what it missed
+            if (marked(node->next(0).load(std::memory_order_acquire))) { search(key, predecessors, successors); }
+            release(node, guard);
+            return true;
+        }
+
+    public:
+        ConcurrentSkipListMap() : _size(0), comp(Comparator{}) {
+            for (Link& level : head) { level.store(0, std::memory_order_relaxed); }
+        }
+
+        ConcurrentSkipListMap(const ConcurrentSkipListMap&) = delete;
+        ConcurrentSkipListMap(ConcurrentSkipListMap&&) = delete;
+        ConcurrentSkipListMap& operator=(const ConcurrentSkipListMap&) = delete;
+        ConcurrentSkipListMap& operator=(ConcurrentSkipListMap&&) = delete;
+
+        // Destructor; no other thread may still be using the map
+        ~ConcurrentSkipListMap() {
+            Node* node = target(head[0].load(std::memory_order_acquire));
+            while (node != nullptr) {
+                Node* next = target(node->next(0).load(std::memory_order_relaxed));
+                destroy(node);
+                node = next;
+            }
+        }
+
+        /**
+         * @brief Return the number of pairs; only a snapshot while other threads are inserting or erasing.
+         */
+        size_type size() const { return _size.load(std::memory_order_relaxed); }
+
+        bool empty() const { return size() == 0; }
+
+        bool contains(const key_type & key) const {
+            EpochGuard guard;
+            Node* node = lower_bound_node(key);
+            return node != nullptr && !comp(key, node->element.first);
+        }
+
+        /**
+         * @brief Copy the value stored under key into value.
+         * @return false (leaving value alone) if key is not present
+         */
+        bool find(const key_type & key, value_type & value) const {
+            EpochGuard guard;
+            Node* node = lower_bound_node(key);
+            if (node == nullptr || comp(key, node->element.first)) { return false; }
+
+            value = node->element.second;
+            return true;
+        }
+
+        /**
+         * @brief Insert x unless its key is already present.
+         * @return whether x was inserted
+         */
+        bool insert(const pair & x) { return insert_pair(x); }
+
+        bool insert(pair && x) { return insert_pair(std::move(x)); }
+
+        /**
+         * @brief Remove key. If several threads erase the same key, exactly one of them succeeds.
+         * @return whether this call removed key
+         */
+        bool erase(const key_type & key) {
+            EpochGuard guard;
+            Node* predecessors[max_height];
+            Node* successors[max_height];
+
+            if (!search(key, predecessors, successors)) { return false; }
+            Node* node = successors[0];
+
+            // mark the shortcuts top down, then the bottom link, whose marking decides which eraser wins
+            for (int level = node->height - 1; level >= 1; level--) {
+                uintptr_t next = node->next(level).load(std::memory_order_acquire);
+                while (!marked(next) && !node->next(level).compare_exchange_weak(next, next | mark, std::memory_order_acq_rel)) {}
+            }
+
+            uintptr_t next = node->next(0).load(std::memory_order_acquire);
+            while (true) {
+                if (marked(next)) { return false; }
+                if (node->next(0).compare_exchange_weak(next, next | mark, std::memory_order_acq_rel)) { break; }
+            }
+
+            _size.fetch_sub(1, std::memory_order_relaxed);
+
+            // unlink it from every level, then let go
+            search(key, predecessors, successors);
+            release(node, guard);
+            return true;
+        }
+
+
+        const_iterator begin() const {
+            EpochGuard guard;
+            Node* node = first_live(target(head[0].load(std::memory_order_acquire)));
+            return const_iterator(node, std::move(guard));
+        }
+
+        const_iterator end() const { return const_iterator(); }
+
+        /**
+         * @brief Return an iterator to the first pair whose key is not less than key, or end().
+         */
+        const_iterator lower_bound(const key_type & key) const {
+            EpochGuard guard;
+            Node* node = lower_bound_node(key);
+            return const_iterator(node, std::move(guard));
+        }
+};
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Epoch-based memory reclamation for lock-free structures. A thread reads shared nodes only while it
+ *        holds an EpochGuard, which announces the global epoch the thread entered in. A node unlinked from a
+ *        structure is retired rather than deleted; it is freed once the global epoch has advanced twice past
+ *        the epoch it was retired in, because by then every thread that could still have been looking at it
+ *        has left its guard. The epoch advances only when every thread inside a guard has caught up with it,
+ *        so a guard held for a long time delays (but never breaks) reclamation.
+ *
+ *        There is one process-wide domain. Each thread gets a record on first use and hands it back on exit;
+ *        the next thread to pick up a record also inherits the nodes still waiting in it.
+ */
+class EpochDomain {
+    public:
+        using deleter_type = void (*)(void*);
+
+    private:
+        struct Retired {
+            void* pointer;
+            deleter_type deleter;
+            uint64_t epoch;
+        };
+
+    public:
+        struct Record {
+            // 0 outside any guard, else 2 * epoch + 1
+            std::atomic<uint64_t> state{0};
+            std::atomic<bool> in_use{false};
+            Record* next = nullptr;
+
+            // touched only by the owning thread
+            size_t depth = 0;
+            size_t retired_since_scan = 0;
+            std::vector<Retired> retired;
+        };
+
+    private:
+        // how many retires a thread batches before trying to advance the epoch and free memory
+        static constexpr size_t scan_interval = 64;
+
+        std::atomic<uint64_t> epoch{1};
+        std::atomic<Record*> records{nullptr};
+
+        EpochDomain() = default;
+
+        // every record that is inside a guard must have announced the current epoch
+        void try_advance() {
+            uint64_t current = epoch.load(std::memory_order_seq_cst);
+            for (Record* record = records.load(std::memory_order_acquire); record != nullptr; record = record->next) {
+                uint64_t state = record->state.load(std::memory_order_seq_cst);
+                if (state != 0 && state != 2 * current + 1) { return; }
+            }
+            epoch.compare_exchange_strong(current, current + 1, std::memory_order_seq_cst);
+        }
+
+        void reclaim(Record* record) {
+            uint64_t current = epoch.load(std::memory_order_seq_cst);
+
+            size_t kept = 0;
+            for (Retired& item : record->retired) {
+                if (item.epoch + 2 <= current) {
+                    item.deleter(item.pointer);
+                }
+                else {
+                    record->retired[kept++] = item;
+                }
+            }
+            record->retired.resize(kept);
+        }
+
+        Record* acquire_record() {
+            for (Record* record = records.load(std::memory_order_acquire); record != nullptr; record = record->next) {
+                bool expected = false;
+                if (!record->in_use.load(std::memory_order_relaxed) &&
+                    record->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                    return record;
+                }
+            }
+
+            Record* record = new Record();
+            record->in_use.store(true, std::memory_order_relaxed);
+            Record* head = records.load(std::memory_order_relaxed);
+            do {
+                record->next = head;
+            } while (!records.compare_exchange_weak(head, record, std::memory_order_release, std::memory_order_relaxed));
+            return record;
+        }
+
+        void release_record(Record* record) {
+            try_advance();
+            reclaim(record);
+            record->in_use.store(false, std::memory_order_release);
+        }
+
+    public:
+        EpochDomain(const EpochDomain&) = delete;
+        EpochDomain& operator=(const EpochDomain&) = delete;
+
+        // never destroyed: threads still running at exit may use it
+        static EpochDomain& global() {
+            static EpochDomain* domain = new EpochDomain();
+            return *domain;
+        }
+
+        // the calling thread's record, acquired on first use and released when the thread exits
+        static Record* local_record() {
+            struct Holder {
+                Record* record;
+                ~Holder() { global().release_record(record); }
+            };
+            thread_local Holder holder{global().acquire_record()};
+            return holder.record;
+        }
+
+        void enter(Record* record) {
+            if (record->depth++ > 0) { return; }
+
+            // announce an epoch that was still current after the announcement became visible
+            uint64_t current = epoch.load(std::memory_order_seq_cst);
+            while (true) {
+                record->state.store(2 * current + 1, std::memory_order_seq_cst);
+                uint64_t now = epoch.load(std::memory_order_seq_cst);
+                if (now == current) { break; }
+                current = now;
+            }
+        }
+
+        void exit(Record* record) {
+            if (--record->depth > 0) { return; }
+            record->state.store(0, std::memory_order_release);
+        }
+
+        /**
+         * @brief Hand over pointer, already unreachable from the shared structure, to be freed with deleter once
+         *        no guard can still see it.
+         */
+        void retire(Record* record, void* pointer, deleter_type deleter) {
+            record->retired.push_back(Retired{pointer, deleter, epoch.load(std::memory_order_seq_cst)});
+
+            if (++record->retired_since_scan >= scan_interval) {
+                record->retired_since_scan = 0;
+                try_advance();
+                reclaim(record);
+            }
+        }
+};
+
+/**
+ * @brief RAII critical section: shared nodes read while the guard is alive are not freed under it. Guards nest,
+ *        and a copy is a nested guard on the same thread, so guards (and anything holding one) must stay on the
+ *        thread that created them.
+ */
+class EpochGuard {
+    EpochDomain::Record* record;
+
+    public:
+        EpochGuard() : record(EpochDomain::local_record()) { EpochDomain::global().enter(record); }
+
+        // a disengaged guard, which protects nothing
+        explicit EpochGuard(std::nullptr_t) : record(nullptr) {}
+
+        // Copy constructor
+        EpochGuard(const EpochGuard& other) : record(other.record) {
+            if (record != nullptr) { EpochDomain::global().enter(record); }
+        }
+
+        // Move constructor
+        EpochGuard(EpochGuard&& other) noexcept : record(other.record) { other.record = nullptr; }
+
+        // Copy assignment operator
+        EpochGuard& operator=(const EpochGuard& other) {
+            EpochGuard copy(other);
+            std::swap(record, copy.record);
+            return *this;
+        }
+
+        // Move assignment operator
+        EpochGuard& operator=(EpochGuard&& other) noexcept {
+            std::swap(record, other.record);
+            return *this;
+        }
+
+        // Destructor
+        ~EpochGuard() {
+            if (record != nullptr) { EpochDomain::global().exit(record); }
+        }
+
+        /**
+         * @brief Retire an unlinked node, to be freed with deleter once no guard can still reach it.
+         */
+        void retire(void* pointer, EpochDomain::deleter_type deleter) {
+            EpochDomain::global().retire(record, pointer, deleter);
+        }
+};
@@ -1,5 +1,24 @@
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#endif
 
 template <typename T>
 void swap(T & a, T & b) { T temp = std::move(a); a = std::move(b); b = std::move(temp); }
@@ -86,68 +105,335 @@ void comb_sort(T* array, size_t size) {
 }
 
 
-// merge sort
+// merge sort and TimSort: stable, generic over random-access iterators, and allocation-free given a scratch
+// buffer of (last - first) / 2 elements (the overloads without one allocate it once up front). Merges move
+// the shorter run into the buffer, and gallop (exponential search, then bulk moves) once one run keeps
+// winning, so presorted stretches cost O(log n) comparisons instead of O(n).
+const size_t merge_sort_threshold = 16;
+const size_t min_gallop_start = 7;
+
+// Uninitialized storage for count elements, brought to life by moving [first, first + count) in and straight
+// back out again: the sorts then only move-assign into it, and T needs no default constructor. Trivially
+// copyable elements are created implicitly by the allocation, so for them the round trip is skipped
 template <typename T>
-void merge(T* array, int left, int mid, int right) {
+class ScratchBuffer {
+    std::allocator<T> alloc;
+    T* data;
+    size_t count;
+
+    public:
+        template <typename RandomIt>
+        ScratchBuffer(RandomIt first, size_t count) : data(alloc.allocate(count)), count(count) {
+            if constexpr (std::is_trivially_copyable<T>::value) { return; }
+
+            try {
+                std::uninitialized_move(first, first + count, data);
+            }
+            catch (...) {
+                alloc.deallocate(data, count);
+                throw;
+            }
+            std::move(data, data + count, first);
+        }
+
+        ScratchBuffer(const ScratchBuffer&) = delete;
+        ScratchBuffer& operator=(const ScratchBuffer&) = delete;
+
+        // Destructor
+        ~ScratchBuffer() {
+            std::destroy(data, data + count);
+            alloc.deallocate(data, count);
+        }
 
-    int left_size = mid - left + 1;
-    int right_size = right - mid; 
+        T* get() const { return data; }
+};
 
-    auto * left_array = new T[left_size];
-    auto * right_array = new T[right_size];
+// sort [first, last) by inserting each element of [start, last) into the sorted prefix [first, start)
+template <typename RandomIt, typename Compare>
+void binary_insertion_sort(RandomIt first, RandomIt start, RandomIt last, Compare comp) {
+    for (RandomIt current = start; current != last; ++current) {
+        RandomIt position = std::upper_bound(first, current, *current, comp);
+        if (position == current) { continue; }
 
-    // move data to the temp arrays
-    for (size_t i = 0; i < left_size; i++) {
-        left_array[i] = std::move(array[left + i]);
+        auto value = std::move(*current);
+        std::move_backward(position, current, current + 1);
+        *position = std::move(value);
     }
+}
 
-    for (size_t i = 0; i < right_size; i++) {
-        right_array[i] = std::move(array[mid + 1 + i]);
+// [first, last) starts with a run of elements satisfying pred; find its end by exponential, then binary search
+template <typename It, typename Predicate>
+It gallop_from_left(It first, It last, Predicate pred) {
+    size_t size = last - first;
+    size_t previous = 0, offset = 1;
+    while (offset <= size && pred(first[offset - 1])) {
+        previous = offset;
+        offset = 2 * offset + 1;
     }
+    if (offset > size) { offset = size; }
+    return std::partition_point(first + previous, first + offset, pred);
+}
 
-    int l = 0;           // index of left array
-    int r = 0;           // index of right array
-    int index = left;    // index of array
+// [first, last) ends with a run of elements satisfying pred; find its start, searching from the end
+template <typename It, typename Predicate>
+It gallop_from_right(It first, It last, Predicate pred) {
+    size_t size = last - first;
+    size_t previous = 0, offset = 1;
+    while (offset <= size && pred(last[-static_cast<ptrdiff_t>(offset)])) {
+        previous = offset;
+        offset = 2 * offset + 1;
+    }
+    if (offset > size) { offset = size; }
+    return std::partition_point(last - offset, last - previous, [&](const auto& x) { return !pred(x); });
+}
+
+// merge the sorted runs [first, mid) and [mid, last), the first of which fits in buffer, front to back
+template <typename RandomIt, typename T, typename Compare>
+void merge_low(RandomIt first, RandomIt mid, RandomIt last, T* buffer, Compare comp, size_t& min_gallop) {
+    T* a = buffer;
+    T* a_end = std::move(first, mid, buffer);
+    RandomIt b = mid;
+    RandomIt out = first;
 
+    while (a != a_end && b != last) {
+        // one element at a time, until one side wins min_gallop times in a row
+        size_t a_wins = 0, b_wins = 0;
+        while (a != a_end && b != last && a_wins < min_gallop && b_wins < min_gallop) {
+            if (comp(*b, *a)) {
+                *out++ = std::move(*b++);
+                b_wins++, a_wins = 0;
+            }
+            else {
+                *out++ = std::move(*a++);
+                a_wins++, b_wins = 0;
+            }
+        }
 
-    // merge the temp arrays back into array[left ... right]
-    while (l < left_size && r < right_size) { 
+        // galloping: move whole stretches, for as long as they stay long
+        while (a != a_end && b != last) {
+            T* a_stop = gallop_from_left(a, a_end, [&](const T& x) { return !comp(*b, x); });
+            size_t a_count = a_stop - a;
+            out = std::move(a, a_stop, out);
+            a = a_stop;
+            if (a == a_end) { break; }
 
-        if (left_array[l] <= right_array[r]) {
-            array[index] = std::move(left_array[l]);
-            l++;
+            RandomIt b_stop = gallop_from_left(b, last, [&](const auto& x) { return comp(x, *a); });
+            size_t b_count = b_stop - b;
+            out = std::move(b, b_stop, out);
+            b = b_stop;
+            if (b == last) { break; }
+
+            if (a_count < min_gallop_start && b_count < min_gallop_start) {
+                min_gallop++;
+                break;
+            }
+            if (min_gallop > 1) { min_gallop--; }
         }
-        else {
-            array[index] = std::move(right_array[r]);
-            r++;
+    }
+
+    // whatever is left of [mid, last) is already in place
+    std::move(a, a_end, out);
+}
+
+// merge the sorted runs [first, mid) and [mid, last), the second of which fits in buffer, back to front
+template <typename RandomIt, typename T, typename Compare>
+void merge_high(RandomIt first, RandomIt mid, RandomIt last, T* buffer, Compare comp, size_t& min_gallop) {
+    RandomIt a = mid;
+    T* b = std::move(mid, last, buffer);
+    RandomIt out = last;
+
+    while (a != first && b != buffer) {
+        size_t a_wins = 0, b_wins = 0;
+        while (a != first && b != buffer && a_wins < min_gallop && b_wins < min_gallop) {
+            // on ties the element of the right run goes last, which keeps the sort stable
+            if (comp(*(b - 1), *(a - 1))) {
+                *--out = std::move(*--a);
+                a_wins++, b_wins = 0;
+            }
+            else {
+                *--out = std::move(*--b);
+                b_wins++, a_wins = 0;
+            }
+        }
+
+        while (a != first && b != buffer) {
+            RandomIt a_start = gallop_from_right(first, a, [&](const auto& x) { return comp(*(b - 1), x); });
+            size_t a_count = a - a_start;
+            out = std::move_backward(a_start, a, out);
+            a = a_start;
+            if (a == first) { break; }
+
+            T* b_start = gallop_from_right(buffer, b, [&](const T& x) { return !comp(x, *(a - 1)); });
+            size_t b_count = b - b_start;
+            out = std::move_backward(b_start, b, out);
+            b = b_start;
+            if (b == buffer) { break; }
+
+            if (a_count < min_gallop_start && b_count < min_gallop_start) {
+                min_gallop++;
+                break;
+            }
+            if (min_gallop > 1) { min_gallop--; }
         }
-        index++;
     }
 
-    while (l < left_size) {
-        array[index] = std::move(left_array[l]);
-        l++, index++;
+    // whatever is left of [first, mid) is already in place
+    std::move_backward(buffer, b, out);
+}
+
+// merge the adjacent sorted runs [first, mid) and [mid, last); buffer must hold the shorter of the two
+template <typename RandomIt, typename T, typename Compare>
+void merge_runs(RandomIt first, RandomIt mid, RandomIt last, T* buffer, Compare comp, size_t& min_gallop) {
+    // elements of the first run not greater than the second run's first are already in place, and so are
+    // elements of the second run not less than the first run's last
+    first = gallop_from_left(first, mid, [&](const auto& x) { return !comp(*mid, x); });
+    if (first == mid) { return; }
+    last = gallop_from_left(mid, last, [&](const auto& x) { return comp(x, *(mid - 1)); });
+    if (mid == last) { return; }
+
+    if (mid - first <= last - mid) {
+        merge_low(first, mid, last, buffer, comp, min_gallop);
+    }
+    else {
+        merge_high(first, mid, last, buffer, comp, min_gallop);
     }
+}
 
-    while (r < right_size) {
-        array[index] = std::move(right_array[r]);
-        r++, index++;
+template <typename RandomIt, typename T, typename Compare>
+void merge_sort_with_buffer(RandomIt first, RandomIt last, T* buffer, Compare comp, size_t& min_gallop) {
+    size_t size = last - first;
+    if (size <= merge_sort_threshold) {
+        if (size > 1) { binary_insertion_sort(first, first + 1, last, comp); }
+        return;
     }
 
-    delete [] left_array;
-    delete [] right_array;
+    RandomIt mid = first + size / 2;
+    merge_sort_with_buffer(first, mid, buffer, comp, min_gallop);
+    merge_sort_with_buffer(mid, last, buffer, comp, min_gallop);
+
+    if (comp(*mid, *(mid - 1))) { merge_runs(first, mid, last, buffer, comp, min_gallop); }
 }
 
+/**
+ * Stable merge sort of [first, last) using buffer, which must have room for (last - first) / 2 elements.
+ */
+template <typename RandomIt, typename Compare = std::less<typename std::iterator_traits<RandomIt>::value_type>>
+void merge_sort(RandomIt first, RandomIt last, typename std::iterator_traits<RandomIt>::value_type* buffer, Compare comp = Compare()) {
+    size_t min_gallop = min_gallop_start;
+    merge_sort_with_buffer(first, last, buffer, comp, min_gallop);
+}
+
+// (the constraint keeps merge_sort(first, last, buffer) from taking the buffer for a comparator)
+template <typename RandomIt, typename Compare = std::less<typename std::iterator_traits<RandomIt>::value_type>>
+requires (!std::is_convertible<Compare, typename std::iterator_traits<RandomIt>::value_type*>::value)
+void merge_sort(RandomIt first, RandomIt last, Compare comp = Compare()) {
+    ScratchBuffer<typename std::iterator_traits<RandomIt>::value_type> buffer(first, (last - first) / 2);
+    merge_sort(first, last, buffer.get(), comp);
+}
+
+// sorts array[left ... right]
 template <typename T>
-void merge_sort(T* array, int left, int right) {
-    // base case
+void merge_sort(T* array, size_t left, size_t right) {
     if (left >= right) { return; }
+    merge_sort(array + left, array + right + 1);
+}
 
-    size_t mid = (left + right) / 2;
 
-    merge_sort(array, left, mid); 
-    merge_sort(array, mid + 1, right);
-    merge(array, left, mid, right); 
+// TimSort: finds the runs already present in the input (reversing strictly descending ones), extends short
+// runs to a minimum length with binary insertion sort, and merges runs from a stack kept in a Fibonacci-like
+// shape, so the merges stay balanced and nearly sorted input sorts in close to linear time
+template <typename RandomIt>
+struct TimSortRun {
+    RandomIt first;
+    size_t size;
+};
+
+// a run length between 32 and 64 such that size / min_run is a power of two or just below one
+inline size_t tim_sort_min_run(size_t size) {
+    size_t low_bits = 0;
+    while (size >= 64) {
+        low_bits |= size & 1;
+        size >>= 1;
+    }
+    return size + low_bits;
+}
+
+// the length of the run starting at first, which is made ascending if it was strictly descending
+template <typename RandomIt, typename Compare>
+size_t count_run(RandomIt first, RandomIt last, Compare comp) {
+    RandomIt end = first + 1;
+    if (end == last) { return 1; }
+
+    if (comp(*end, *first)) {
+        while (++end != last && comp(*end, *(end - 1))) {}
+        for (RandomIt l = first, r = end - 1; l < r; ++l, --r) { std::swap(*l, *r); }
+    }
+    else {
+        while (++end != last && !comp(*end, *(end - 1))) {}
+    }
+    return end - first;
+}
+
+/**
+ * Stable TimSort of [first, last) using buffer, which must have room for (last - first) / 2 elements.
+ */
+template <typename RandomIt, typename Compare = std::less<typename std::iterator_traits<RandomIt>::value_type>>
+void tim_sort(RandomIt first, RandomIt last, typename std::iterator_traits<RandomIt>::value_type* buffer, Compare comp = Compare()) {
+    size_t size = last - first;
+    if (size < 2) { return; }
+
+    // the stack invariants bound its height by log_phi(n)
+    TimSortRun<RandomIt> runs[96];
+    size_t count = 0;
+    size_t min_run = tim_sort_min_run(size);
+    size_t min_gallop = min_gallop_start;
+
+    auto merge_at = [&](size_t i) {
+        RandomIt mid = runs[i + 1].first;
+        merge_runs(runs[i].first, mid, mid + runs[i + 1].size, buffer, comp, min_gallop);
+        runs[i].size += runs[i + 1].size;
+        if (i + 3 == count) { runs[i + 1] = runs[i + 2]; }
+        count--;
+    };
+
+    for (RandomIt start = first; start != last; ) {
+        size_t run = count_run(start, last, comp);
+
+        if (run < min_run) {
+            size_t extended = std::min<size_t>(min_run, last - start);
+            binary_insertion_sort(start, start + run, start + extended, comp);
+            run = extended;
+        }
+
+        runs[count++] = TimSortRun<RandomIt>{start, run};
+        start += run;
+
+        // restore the invariants: each run is longer than the next one, and than the next two together
+        while (count > 1) {
+            size_t i = count - 2;
+            if ((i >= 1 && runs[i - 1].size <= runs[i].size + runs[i + 1].size) ||
+                (i >= 2 && runs[i - 2].size <= runs[i - 1].size + runs[i].size)) {
+                if (runs[i - 1].size < runs[i + 1].size) { i--; }
+            }
+            else if (runs[i].size > runs[i + 1].size) {
+                break;
+            }
+            merge_at(i);
+        }
+    }
+
+    while (count > 1) {
+        size_t i = count - 2;
+        if (i > 0 && runs[i - 1].size < runs[i + 1].size) { i--; }
+        merge_at(i);
+    }
+}
+
+template <typename RandomIt, typename Compare = std::less<typename std::iterator_traits<RandomIt>::value_type>>
+requires (!std::is_convertible<Compare, typename std::iterator_traits<RandomIt>::value_type*>::value)
+void tim_sort(RandomIt first, RandomIt last, Compare comp = Compare()) {
+    ScratchBuffer<typename std::iterator_traits<RandomIt>::value_type> buffer(first, (last - first) / 2);
+    tim_sort(first, last, buffer.get(), comp);
 }
 
 
@@ -185,4 +471,1054 @@ void quick_sort(T* array, int left, int right) {
 }
 
 
+// introsort: quicksort with a median-of-three / ninther pivot, insertion sort for small partitions, and a
+// heapsort fallback once the recursion gets deeper than 2 log2(n), so the worst case stays O(n log n)
+const size_t introsort_threshold = 16;
+const size_t ninther_threshold = 128;
+
+// insertion sort with a comparator; moves each element into a hole instead of swapping it down
+template <typename T, typename Compare>
+void insertion_sort(T* array, size_t size, Compare comp) {
+    for (size_t i = 1; i < size; i++) {
+        if (!comp(array[i], array[i - 1])) { continue; }
+
+        T value = std::move(array[i]);
+        size_t j = i;
+        do {
+            array[j] = std::move(array[j - 1]);
+            j--;
+        } while (j > 0 && comp(value, array[j - 1]));
+        array[j] = std::move(value);
+    }
+}
+
+
+// heap sort
+template <typename T, typename Compare>
+void sift_down(T* array, size_t index, size_t size, Compare comp) {
+    T value = std::move(array[index]);
+    size_t child;
+
+    while ((child = 2 * index + 1) < size) {
+        if (child + 1 < size && comp(array[child], array[child + 1])) { child++; }
+        if (!comp(value, array[child])) { break; }
+
+        array[index] = std::move(array[child]);
+        index = child;
+    }
+    array[index] = std::move(value);
+}
+
+template <typename T, typename Compare = std::less<T>>
+void heap_sort(T* array, size_t size, Compare comp = Compare()) {
+    if (size < 2) { return; }
+
+    for (size_t i = size / 2; i > 0; i--) { sift_down(array, i - 1, size, comp); }
+
+    for (size_t end = size - 1; end > 0; end--) {
+        std::swap(array[0], array[end]);
+        sift_down(array, 0, end, comp);
+    }
+}
+
+
+// put a, b and c in order
+template <typename T, typename Compare>
+void sort3(T& a, T& b, T& c, Compare comp) {
+    if (comp(b, a)) { std::swap(a, b); }
+    if (comp(c, b)) {
+        std::swap(b, c);
+        if (comp(b, a)) { std::swap(a, b); }
+    }
+}
+
+// move the pivot, a median of three (or for large partitions the median of three medians), to array[0]
+template <typename T, typename Compare>
+void choose_pivot(T* array, size_t size, Compare comp) {
+    size_t mid = size / 2;
+
+    if (size > ninther_threshold) {
+        sort3(array[0], array[mid], array[size - 1], comp);
+        sort3(array[1], array[mid - 1], array[size - 2], comp);
+        sort3(array[2], array[mid + 1], array[size - 3], comp);
+        sort3(array[mid - 1], array[mid], array[mid + 1], comp);
+        std::swap(array[0], array[mid]);
+    }
+    else {
+        sort3(array[mid], array[0], array[size - 1], comp);
+    }
+}
+
+// Hoare partition around array[0]; elements equal to the pivot are spread over both sides, so runs of
+// duplicates still split evenly. Returns the pivot's final index.
+template <typename T, typename Compare>
+size_t partition_around_first(T* array, size_t size, Compare comp) {
+    size_t left = 1;
+    size_t right = size - 1;
+
+    while (true) {
+        while (left <= right && comp(array[left], array[0])) { left++; }
+        while (left <= right && comp(array[0], array[right])) { right--; }
+        if (left >= right) { break; }
+
+        std::swap(array[left], array[right]);
+        left++, right--;
+    }
+
+    std::swap(array[0], array[right]);
+    return right;
+}
+
+template <typename T, typename Compare>
+void introsort_loop(T* array, size_t size, size_t depth_limit, Compare comp) {
+    while (size > introsort_threshold) {
+        if (depth_limit == 0) {
+            heap_sort(array, size, comp);
+            return;
+        }
+        depth_limit--;
+
+        choose_pivot(array, size, comp);
+        size_t p = partition_around_first(array, size, comp);
+
+        // recurse into the smaller side and loop on the larger one, so the stack stays O(log n)
+        if (p < size - p - 1) {
+            introsort_loop(array, p, depth_limit, comp);
+            array += p + 1;
+            size -= p + 1;
+        }
+        else {
+            introsort_loop(array + p + 1, size - p - 1, depth_limit, comp);
+            size = p;
+        }
+    }
+
+    insertion_sort(array, size, comp);
+}
+
+template <typename T, typename Compare = std::less<T>>
+void introsort(T* array, size_t size, Compare comp = Compare()) {
+    if (size < 2) { return; }
+    introsort_loop(array, size, 2 * (std::bit_width(size) - 1), comp);
+}
+
+
+// pattern-defeating quicksort (pdqsort, Orson Peters): introsort whose partitioning does not branch on the
+// comparisons (BlockQuicksort, Edelkamp and Weiss), which recognises partitions that were already in order,
+// gives runs of keys equal to an earlier pivot a linear-time pass, and swaps elements around after a badly
+// unbalanced partition to break up patterns that would defeat the pivot choice. The helpers work on
+// [begin, end) pointer ranges.
+const size_t pdq_insertion_threshold = 24;
+const size_t pdq_block_size = 64;
+const size_t partial_insertion_sort_limit = 8;
+
+// insertion sort that gives up (returning false) once it has moved more than a few elements
+template <typename T, typename Compare>
+bool partial_insertion_sort(T* begin, T* end, Compare comp) {
+    if (begin == end) { return true; }
+
+    size_t moved = 0;
+    for (T* current = begin + 1; current != end; current++) {
+        if (comp(*current, *(current - 1))) {
+            T value = std::move(*current);
+            T* hole = current;
+            do {
+                *hole = std::move(*(hole - 1));
+                hole--;
+            } while (hole != begin && comp(value, *(hole - 1)));
+            *hole = std::move(value);
+            moved += current - hole;
+        }
+
+        if (moved > partial_insertion_sort_limit) { return false; }
+    }
+    return true;
+}
+
+// swap the misplaced elements recorded in two offset buffers; with unequal counts a cyclic permutation
+// takes half the moves of the swaps
+template <typename T>
+void swap_offsets(T* first, T* last, const unsigned char* offsets_l, const unsigned char* offsets_r, size_t count, bool use_swaps) {
+    if (use_swaps) {
+        for (size_t i = 0; i < count; i++) { std::swap(*(first + offsets_l[i]), *(last - offsets_r[i])); }
+    }
+    else if (count > 0) {
+        T* l = first + offsets_l[0];
+        T* r = last - offsets_r[0];
+        T value = std::move(*l);
+        *l = std::move(*r);
+        for (size_t i = 1; i < count; i++) {
+            l = first + offsets_l[i];
+            *r = std::move(*l);
+            r = last - offsets_r[i];
+            *l = std::move(*r);
+        }
+        *r = std::move(value);
+    }
+}
+
+/**
+ * Partition [begin, end) around the pivot *begin into elements less than it and elements not less than it.
+ * Blocks of comparison results are first written to offset buffers without branching and then swapped in
+ * bulk, so mispredictions do not dominate on random data.
+ * Returns the pivot's final position and whether the range was already partitioned.
+ */
+template <typename T, typename Compare>
+std::pair<T*, bool> partition_right_branchless(T* begin, T* end, Compare comp) {
+    T pivot = std::move(*begin);
+    T* first = begin;
+    T* last = end;
+
+    // the median-of-three pivot choice guarantees an element not less than the pivot in range
+    while (comp(*++first, pivot)) {}
+
+    // if first is the first element there is no sentinel on the left, so that scan needs a bound
+    if (first - 1 == begin) {
+        while (first < last && !comp(*--last, pivot)) {}
+    }
+    else {
+        while (!comp(*--last, pivot)) {}
+    }
+
+    bool already_partitioned = first >= last;
+    if (!already_partitioned) {
+        std::swap(*first, *last);
+        first++;
+
+        alignas(64) unsigned char offsets_l[pdq_block_size];
+        alignas(64) unsigned char offsets_r[pdq_block_size];
+        T* offsets_l_base = first;
+        T* offsets_r_base = last;
+        size_t num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+
+        while (first < last) {
+            // fill whichever buffers are empty, splitting what is left when both are
+            size_t num_unknown = last - first;
+            size_t left_split = (num_l == 0) ? ((num_r == 0) ? num_unknown / 2 : num_unknown) : 0;
+            size_t right_split = (num_r == 0) ? (num_unknown - left_split) : 0;
+
+            size_t left_count = (left_split < pdq_block_size) ? left_split : pdq_block_size;
+            for (size_t i = 0; i < left_count; i++) {
+                offsets_l[num_l] = static_cast<unsigned char>(i);
+                num_l += !comp(*first, pivot);
+                first++;
+            }
+
+            size_t right_count = (right_split < pdq_block_size) ? right_split : pdq_block_size;
+            for (size_t i = 0; i < right_count; i++) {
+                offsets_r[num_r] = static_cast<unsigned char>(i + 1);
+                num_r += comp(*--last, pivot);
+            }
+
+            size_t count = (num_l < num_r) ? num_l : num_r;
+            swap_offsets(offsets_l_base, offsets_r_base, offsets_l + start_l, offsets_r + start_r, count, num_l == num_r);
+            num_l -= count, num_r -= count;
+            start_l += count, start_r += count;
+
+            if (num_l == 0) { start_l = 0; offsets_l_base = first; }
+            if (num_r == 0) { start_r = 0; offsets_r_base = last; }
+        }
+
+        // at most one buffer still holds misplaced elements; move them to the boundary
+        if (num_l > 0) {
+            const unsigned char* offsets = offsets_l + start_l;
+            while (num_l-- > 0) { std::swap(*(offsets_l_base + offsets[num_l]), *--last); }
+            first = last;
+        }
+        if (num_r > 0) {
+            const unsigned char* offsets = offsets_r + start_r;
+            while (num_r-- > 0) { std::swap(*(offsets_r_base - offsets[num_r]), *first); first++; }
+            last = first;
+        }
+    }
+
+    T* pivot_position = first - 1;
+    *begin = std::move(*pivot_position);
+    *pivot_position = std::move(pivot);
+    return std::make_pair(pivot_position, already_partitioned);
+}
+
+// Partition [begin, end) around *begin into elements not greater than it and elements greater than it.
+// Used when the pivot equals the element just before the range, so the left side is all equal keys.
+template <typename T, typename Compare>
+T* partition_left(T* begin, T* end, Compare comp) {
+    T pivot = std::move(*begin);
+    T* first = begin;
+    T* last = end;
+
+    while (comp(pivot, *--last)) {}
+
+    if (last + 1 == end) {
+        while (first < last && !comp(pivot, *++first)) {}
+    }
+    else {
+        while (!comp(pivot, *++first)) {}
+    }
+
+    while (first < last) {
+        std::swap(*first, *last);
+        while (comp(pivot, *--last)) {}
+        while (!comp(pivot, *++first)) {}
+    }
+
+    *begin = std::move(*last);
+    *last = std::move(pivot);
+    return last;
+}
+
+template <typename T, typename Compare>
+void pdq_sort_loop(T* begin, T* end, Compare comp, size_t bad_allowed, bool leftmost) {
+    while (true) {
+        size_t size = end - begin;
+
+        if (size < pdq_insertion_threshold) {
+            insertion_sort(begin, size, comp);
+            return;
+        }
+
+        choose_pivot(begin, size, comp);
+
+        // nothing in the range is less than the element before it (the previous pivot); if the new pivot is
+        // equal to it, every key equal to the pivot goes left and that side needs no further sorting
+        if (!leftmost && !comp(*(begin - 1), *begin)) {
+            begin = partition_left(begin, end, comp) + 1;
+            continue;
+        }
+
+        std::pair<T*, bool> result = partition_right_branchless(begin, end, comp);
+        T* pivot_position = result.first;
+        bool already_partitioned = result.second;
+
+        size_t l_size = pivot_position - begin;
+        size_t r_size = end - (pivot_position + 1);
+        bool highly_unbalanced = l_size < size / 8 || r_size < size / 8;
+
+        if (highly_unbalanced) {
+            // too many bad partitions: guarantee O(n log n)
+            if (--bad_allowed == 0) {
+                heap_sort(begin, size, comp);
+                return;
+            }
+
+            // swap elements around so the next pivot choices see a different pattern
+            if (l_size >= pdq_insertion_threshold) {
+                std::swap(*begin, *(begin + l_size / 4));
+                std::swap(*(pivot_position - 1), *(pivot_position - l_size / 4));
+
+                if (l_size > ninther_threshold) {
+                    std::swap(*(begin + 1), *(begin + (l_size / 4 + 1)));
+                    std::swap(*(begin + 2), *(begin + (l_size / 4 + 2)));
+                    std::swap(*(pivot_position - 2), *(pivot_position - (l_size / 4 + 1)));
+                    std::swap(*(pivot_position - 3), *(pivot_position - (l_size / 4 + 2)));
+                }
+            }
+
+            if (r_size >= pdq_insertion_threshold) {
+                std::swap(*(pivot_position + 1), *(pivot_position + (1 + r_size / 4)));
+                std::swap(*(end - 1), *(end - r_size / 4));
+
+                if (r_size > ninther_threshold) {
+                    std::swap(*(pivot_position + 2), *(pivot_position + (2 + r_size / 4)));
+                    std::swap(*(pivot_position + 3), *(pivot_position + (3 + r_size / 4)));
+                    std::swap(*(end - 2), *(end - (1 + r_size / 4)));
+                    std::swap(*(end - 3), *(end - (2 + r_size / 4)));
+                }
+            }
+        }
+        else if (already_partitioned && partial_insertion_sort(begin, pivot_position, comp) &&
+                 partial_insertion_sort(pivot_position + 1, end, comp)) {
+            // a balanced partition that moved nothing, on input that turned out (nearly) sorted
+            return;
+        }
+
+        pdq_sort_loop(begin, pivot_position, comp, bad_allowed, leftmost);
+        begin = pivot_position + 1;
+        leftmost = false;
+    }
+}
+
+template <typename T, typename Compare = std::less<T>>
+void pdq_sort(T* array, size_t size, Compare comp = Compare()) {
+    if (size < 2) { return; }
+    pdq_sort_loop(array, array + size, comp, std::bit_width(size) - 1, true);
+}
+
+// LSD radix sort for integer and floating-point keys: stable, O(n) per digit, no comparisons. key projects an
+// element to its sort key (the element itself by default, or e.g. &Record::id). Keys are mapped to unsigned
+// integers whose order matches theirs: signed integers get their sign bit flipped, floating-point numbers
+// all their bits if negative and just the sign bit if not (so -0.0 sorts before 0.0, and NaNs at the ends).
+template <typename Key>
+auto radix_bits(Key key) {
+    if constexpr (std::is_floating_point<Key>::value) {
+        using U = typename std::conditional<sizeof(Key) == 4, uint32_t, uint64_t>::type;
+        U bits = std::bit_cast<U>(key);
+        U sign = U(1) << (8 * sizeof(U) - 1);
+        return (bits & sign) ? U(~bits) : U(bits ^ sign);
+    }
+    else if constexpr (std::is_signed<Key>::value) {
+        using U = typename std::make_unsigned<Key>::type;
+        return U(U(key) ^ (U(1) << (8 * sizeof(U) - 1)));
+    }
+    else {
+        return key;
+    }
+}
+
+// how many elements ahead the scatter prefetches its write position, for elements of at most
+// radix_prefetch_max_size bytes. On 16M random keys (best of 5) this took uint32_t from 490 to 281 ms, uint64_t
+// from 1474 to 991 ms and 16-byte records from 1836 to 980 ms; for 32-byte records it was within run-to-run
+// noise either way. Prefetching ahead of the histogram read bought nothing, being one sequential scan the
+// hardware already prefetches (511 vs 490 ms for uint32_t), so it is not done
+const size_t radix_prefetch_distance = 16;
+const size_t radix_prefetch_max_size = 16;
+
+/**
+ * LSD radix sort of array[0 ... size) using buffer, which must have room for size elements. 32-bit keys go
+ * in three 11-bit digits, others in 8-bit digits (so the histograms stay in L1). The histograms of all digits
+ * are built in one read of the input, and a digit that is the same for every element is skipped. The scatter
+ * writes to as many places as there are buckets, so small elements prefetch their destination a few ahead.
+ */
+template <typename T, typename Projection = std::identity>
+void radix_sort(T* array, size_t size, T* buffer, Projection key = Projection()) {
+    using Key = typename std::decay<decltype(std::invoke(key, array[0]))>::type;
+    using U = decltype(radix_bits(std::declval<Key>()));
+
+    const size_t key_bits = 8 * sizeof(U);
+    const size_t digit_bits = (key_bits == 32) ? 11 : 8;
+    const size_t passes = (key_bits + digit_bits - 1) / digit_bits;
+    const size_t buckets = size_t(1) << digit_bits;
+    const U mask = U(buckets - 1);
+
+    if (size < 2) { return; }
+
+    std::vector<size_t> counts(passes * buckets, 0);
+    for (size_t i = 0; i < size; i++) {
+        U bits = radix_bits(std::invoke(key, array[i]));
+        for (size_t pass = 0; pass < passes; pass++) { counts[pass * buckets + ((bits >> (pass * digit_bits)) & mask)]++; }
+    }
+
+    T* from = array;
+    T* to = buffer;
+
+    for (size_t pass = 0; pass < passes; pass++) {
+        size_t* count = counts.data() + pass * buckets;
+
+        // every element has the same digit: this pass would not move anything
+        U first_digit = (radix_bits(std::invoke(key, from[0])) >> (pass * digit_bits)) & mask;
+        if (count[first_digit] == size) { continue; }
+
+        // bucket sizes -> bucket starts
+        size_t sum = 0;
+        for (size_t b = 0; b < buckets; b++) {
+            size_t c = count[b];
+            count[b] = sum;
+            sum += c;
+        }
+
+        for (size_t i = 0; i < size; i++) {
+#if defined(__GNUC__)
+            if constexpr (sizeof(T) <= radix_prefetch_max_size) {
+                if (i + radix_prefetch_distance < size) {
+                    U ahead = (radix_bits(std::invoke(key, from[i + radix_prefetch_distance])) >> (pass * digit_bits)) & mask;
+                    __builtin_prefetch(&to[count[ahead]], 1);
+                }
+            }
+#endif
+            U digit = (radix_bits(std::invoke(key, from[i])) >> (pass * digit_bits)) & mask;
+            to[count[digit]++] = std::move(from[i]);
+        }
+
+        T* temp = from;
+        from = to;
+        to = temp;
+    }
+
+    if (from != array) { std::move(from, from + size, array); }
+}
+
+// (the constraint keeps radix_sort(array, size, buffer) from taking the buffer for a projection)
+template <typename T, typename Projection = std::identity>
+requires (!std::is_convertible<Projection, T*>::value)
+void radix_sort(T* array, size_t size, Projection key = Projection()) {
+    if (size < 2) { return; }
+
+    ScratchBuffer<T> buffer(array, size);
+    radix_sort(array, size, buffer.get(), key);
+}
+
+
+// MSD radix sort for strings (American flag sort, McIlroy, Bostic and McIlroy): buckets the elements in place
+// by the character at the current depth, then sorts each bucket by the next character, with insertion sort
+// for small buckets. Not stable. key projects an element to its string (std::string, std::string_view or
+// const char*); characters compare as unsigned, as in std::string.
+const size_t string_sort_threshold = 32;
+
+// A C string is read in place rather than measured: a string is only looked at depth when its first depth
+// characters matched a longer string's, so depth never passes its terminator
+template <typename S>
+constexpr bool is_c_string = std::is_pointer<std::remove_cvref_t<S>>::value;
+
+// the bucket of the string's character at depth: 0 once the string has ended, else the character + 1
+template <typename T, typename Projection>
+size_t string_bucket(const T& x, size_t depth, Projection& key) {
+    auto&& projected = std::invoke(key, x);
+    if constexpr (is_c_string<decltype(projected)>) {
+        unsigned char c = static_cast<unsigned char>(projected[depth]);
+        return (c != 0) ? size_t(c) + 1 : 0;
+    }
+    else {
+        std::string_view s(projected);
+        return (depth < s.size()) ? size_t(static_cast<unsigned char>(s[depth])) + 1 : 0;
+    }
+}
+
+// insertion sort of strings that all share their first depth characters
+template <typename T, typename Projection>
+void string_insertion_sort(T* array, size_t size, size_t depth, Projection& key) {
+    auto less = [&](const T& a, const T& b) {
+        auto&& pa = std::invoke(key, a);
+        auto&& pb = std::invoke(key, b);
+        if constexpr (is_c_string<decltype(pa)> && is_c_string<decltype(pb)>) {
+            // strcmp compares the characters as unsigned char
+            return std::strcmp(pa + depth, pb + depth) < 0;
+        }
+        else {
+            return std::string_view(pa).substr(depth) < std::string_view(pb).substr(depth);
+        }
+    };
+    for (size_t i = 1; i < size; i++) {
+        if (!less(array[i], array[i - 1])) { continue; }
+
+        T value = std::move(array[i]);
+        size_t j = i;
+        do {
+            array[j] = std::move(array[j - 1]);
+            j--;
+        } while (j > 0 && less(value, array[j - 1]));
+        array[j] = std::move(value);
+    }
+}
+
+template <typename T, typename Projection = std::identity>
+void string_radix_sort(T* array, size_t size, Projection key = Projection()) {
+    struct Bucket {
+        T* array;
+        size_t size;
+        size_t depth;
+    };
+
+    const size_t buckets = 257;
+
+    // an explicit stack, since a long common prefix means one level per character
+    std::vector<Bucket> stack;
+    stack.push_back(Bucket{array, size, 0});
+
+    size_t count[buckets];
+    size_t next[buckets];
+
+    while (!stack.empty()) {
+        Bucket current = stack.back();
+        stack.pop_back();
+
+        if (current.size <= string_sort_threshold) {
+            string_insertion_sort(current.array, current.size, current.depth, key);
+            continue;
+        }
+
+        std::fill(count, count + buckets, 0);
+        for (size_t i = 0; i < current.size; i++) { count[string_bucket(current.array[i], current.depth, key)]++; }
+
+        size_t sum = 0;
+        for (size_t b = 0; b < buckets; b++) {
+            next[b] = sum;
+            sum += count[b];
+        }
+
+        // cycle every element into its bucket; next[b] is the first slot of bucket b not yet filled
+        size_t end = 0;
+        for (size_t b = 0; b < buckets; b++) {
+            end += count[b];
+            while (next[b] < end) {
+                size_t target = string_bucket(current.array[next[b]], current.depth, key);
+                if (target == b) {
+                    next[b]++;
+                }
+                else {
+                    std::swap(current.array[next[b]], current.array[next[target]++]);
+                }
+            }
+        }
+
+        // strings that ended (bucket 0) are equal and done; the others continue one character deeper
+        size_t start = count[0];
+        for (size_t b = 1; b < buckets; b++) {
+            if (count[b] > 1) { stack.push_back(Bucket{current.array + start, count[b], current.depth + 1}); }
+            start += count[b];
+        }
+    }
+}
+
+// Parallel sort: parallel sorting by regular sampling (Shi and Schaeffer). Inputs below the threshold, or
+// runs with fewer than two threads, are sorted sequentially with pdq_sort.
+const size_t parallel_sort_threshold = 1 << 16;
+
+// the smallest chunk worth giving a thread of its own
+const size_t parallel_sort_min_chunk = 1 << 14;
+
+// run task(0), ..., task(count - 1) on count threads (one of them the caller) and wait for all of them; the
+// first exception thrown by a task is rethrown once every thread has finished
+template <typename Task>
+void parallel_for(size_t count, Task task) {
+    std::vector<std::exception_ptr> errors(count);
+    std::vector<std::thread> workers;
+    workers.reserve(count);
+
+    auto run = [&](size_t i) {
+        try { task(i); }
+        catch (...) { errors[i] = std::current_exception(); }
+    };
+
+    try {
+        for (size_t i = 1; i < count; i++) { workers.emplace_back(run, i); }
+    }
+    catch (...) {
+        for (std::thread& worker : workers) { worker.join(); }
+        throw;
+    }
+
+    run(0);
+    for (std::thread& worker : workers) { worker.join(); }
+
+    for (std::exception_ptr& error : errors) {
+        if (error) { std::rethrow_exception(error); }
+    }
+}
+
+/**
+ * Sort array[0 ... size) on threads threads (0 means one per hardware thread), in four parallel rounds:
+ *  1. split the array into one chunk per thread and pdq_sort each chunk;
+ *  2. take threads evenly spaced samples from every sorted chunk, sort them, and pick threads - 1 of them as
+ *     splitters, which bounds every bucket to about twice its fair share;
+ *  3. each thread finds where the splitters cut its chunk, then moves every piece into its bucket in a buffer;
+ *  4. each thread sorts one bucket, which is a concatenation of sorted runs that tim_sort merges, and moves
+ *     it back into place.
+ * Not stable. Many copies of a single key all land in the same bucket, which then does more of the work.
+ */
+template <typename T, typename Compare = std::less<T>>
+void parallel_sort(T* array, size_t size, Compare comp = Compare(), size_t threads = 0) {
+    if (threads == 0) { threads = std::max<size_t>(std::thread::hardware_concurrency(), 1); }
+    threads = std::min(threads, size / parallel_sort_min_chunk);
+
+    if (size < parallel_sort_threshold || threads < 2) {
+        pdq_sort(array, size, comp);
+        return;
+    }
+
+    const size_t p = threads;
+    auto chunk_start = [&](size_t i) { return size * i / p; };
+
+    // 1. sort the chunks
+    parallel_for(p, [&](size_t i) { pdq_sort(array + chunk_start(i), chunk_start(i + 1) - chunk_start(i), comp); });
+
+    // 2. regular samples, and the splitters between buckets
+    std::vector<T> samples;
+    samples.reserve(p * p);
+    for (size_t i = 0; i < p; i++) {
+        size_t length = chunk_start(i + 1) - chunk_start(i);
+        for (size_t j = 0; j < p; j++) { samples.push_back(array[chunk_start(i) + length * j / p]); }
+    }
+    pdq_sort(samples.data(), samples.size(), comp);
+
+    std::vector<T> splitters;
+    splitters.reserve(p - 1);
+    for (size_t k = 1; k < p; k++) { splitters.push_back(samples[k * p + p / 2 - 1]); }
+
+    // 3. cut each chunk at the splitters: bucket k of chunk i is [cut[i][k], cut[i][k + 1])
+    std::vector<size_t> cuts(p * (p + 1));
+    auto cut = [&](size_t i, size_t k) -> size_t& { return cuts[i * (p + 1) + k]; };
+
+    parallel_for(p, [&](size_t i) {
+        T* first = array + chunk_start(i);
+        T* last = array + chunk_start(i + 1);
+        cut(i, 0) = chunk_start(i);
+        for (size_t k = 1; k < p; k++) {
+            first = std::upper_bound(first, last, splitters[k - 1], comp);
+            cut(i, k) = first - array;
+        }
+        cut(i, p) = chunk_start(i + 1);
+    });
+
+    // where each piece goes: the buckets in order, and within a bucket the pieces in chunk order
+    std::vector<size_t> bucket_start(p + 1, 0);
+    std::vector<size_t> destinations(p * p);
+    size_t offset = 0;
+    for (size_t k = 0; k < p; k++) {
+        bucket_start[k] = offset;
+        for (size_t i = 0; i < p; i++) {
+            destinations[i * p + k] = offset;
+            offset += cut(i, k + 1) - cut(i, k);
+        }
+    }
+    bucket_start[p] = size;
+
+    ScratchBuffer<T> buffer(array, size);
+    parallel_for(p, [&](size_t i) {
+        for (size_t k = 0; k < p; k++) { std::move(array + cut(i, k), array + cut(i, k + 1), buffer.get() + destinations[i * p + k]); }
+    });
+
+    // 4. merge each bucket's runs, with the bucket's (now vacated) stretch of array as scratch space
+    parallel_for(p, [&](size_t k) {
+        T* first = buffer.get() + bucket_start[k];
+        T* last = buffer.get() + bucket_start[k + 1];
+        tim_sort(first, last, array + bucket_start[k], comp);
+        std::move(first, last, array + bucket_start[k]);
+    });
+}
+
+// Vectorized sort of int32_t, int64_t and float arrays: a quicksort whose partition step classifies and
+// stores a whole vector at a time, with an in-register bitonic sorting network as the base case. Uses AVX2
+// when the CPU has it (checked at run time; the kernels are compiled for AVX2 with target attributes, so
+// the rest of the program needs no special flags), and falls back to pdq_sort otherwise.
+const size_t simd_block_size = 64;
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define SORTING_AVX2 __attribute__((target("avx2")))
+
+inline bool cpu_has_avx2() {
+    static const bool supported = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return supported;
+}
+
+// One compare-exchange layer of a bitonic network within a vector, in 32-bit words (a 64-bit lane is two)
+struct BitonicLayer {
+    int32_t partner[8];
+    int32_t takes_max[8];
+};
+
+// the layer that compares lanes distance apart, ascending within every other block of lanes
+constexpr BitonicLayer bitonic_layer(size_t lanes, size_t block, size_t distance) {
+    BitonicLayer layer{};
+    size_t words = 8 / lanes;
+    for (size_t i = 0; i < lanes; i++) {
+        bool takes_max = ((i & distance) != 0) != ((i & block) != 0);
+        for (size_t w = 0; w < words; w++) {
+            layer.partner[i * words + w] = int32_t((i ^ distance) * words + w);
+            layer.takes_max[i * words + w] = takes_max ? -1 : 0;
+        }
+    }
+    return layer;
+}
+
+template <size_t Lanes>
+struct SimdTables {
+    static constexpr size_t log_lanes = std::bit_width(Lanes) - 1;
+    static constexpr size_t words = 8 / Lanes;
+
+    // sorts one vector
+    static constexpr std::array<BitonicLayer, log_lanes * (log_lanes + 1) / 2> sort = [] {
+        std::array<BitonicLayer, log_lanes * (log_lanes + 1) / 2> layers{};
+        size_t n = 0;
+        for (size_t block = 2; block <= Lanes; block *= 2) {
+            for (size_t distance = block / 2; distance > 0; distance /= 2) { layers[n++] = bitonic_layer(Lanes, block, distance); }
+        }
+        return layers;
+    }();
+
+    // sorts one bitonic vector
+    static constexpr std::array<BitonicLayer, log_lanes> merge = [] {
+        std::array<BitonicLayer, log_lanes> layers{};
+        size_t n = 0;
+        for (size_t distance = Lanes / 2; distance > 0; distance /= 2) { layers[n++] = bitonic_layer(Lanes, Lanes, distance); }
+        return layers;
+    }();
+
+    static constexpr std::array<int32_t, 8> reverse = [] {
+        std::array<int32_t, 8> words_order{};
+        for (size_t i = 0; i < Lanes; i++) {
+            for (size_t w = 0; w < words; w++) { words_order[i * words + w] = int32_t((Lanes - 1 - i) * words + w); }
+        }
+        return words_order;
+    }();
+
+    // for each mask of lanes that belong on the right: a permutation that moves the other lanes to the front
+    // and those lanes to the back, both in their original order
+    static constexpr std::array<std::array<int32_t, 8>, (size_t(1) << Lanes)> compress = [] {
+        std::array<std::array<int32_t, 8>, (size_t(1) << Lanes)> table{};
+        for (size_t mask = 0; mask < table.size(); mask++) {
+            size_t n = 0;
+            for (int right = 0; right < 2; right++) {
+                for (size_t i = 0; i < Lanes; i++) {
+                    if (((mask >> i) & 1) != size_t(right)) { continue; }
+                    for (size_t w = 0; w < words; w++) { table[mask][n * words + w] = int32_t(i * words + w); }
+                    n++;
+                }
+            }
+        }
+        return table;
+    }();
+};
+
+// Per-type AVX2 operations; every vector is held as __m256i
+struct Avx2Int32 {
+    using type = int32_t;
+    static constexpr size_t lanes = 8;
+    static constexpr type max_value = std::numeric_limits<type>::max();
+
+    static SORTING_AVX2 __m256i set1(type x) { return _mm256_set1_epi32(x); }
+
+    static SORTING_AVX2 __m256i min(__m256i a, __m256i b) { return _mm256_min_epi32(a, b); }
+
+    static SORTING_AVX2 __m256i max(__m256i a, __m256i b) { return _mm256_max_epi32(a, b); }
+
+    // bit i is set if lane i of a is greater than (Strict) or not less than lane i of b
+    template <bool Strict>
+    static SORTING_AVX2 int greater_mask(__m256i a, __m256i b) {
+        if constexpr (Strict) { return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(a, b))); }
+        else { return ~_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(b, a))) & 0xFF; }
+    }
+};
+
+struct Avx2Int64 {
+    using type = int64_t;
+    static constexpr size_t lanes = 4;
+    static constexpr type max_value = std::numeric_limits<type>::max();
+
+    static SORTING_AVX2 __m256i set1(type x) { return _mm256_set1_epi64x(x); }
+
+    // AVX2 has no 64-bit min and max
+    static SORTING_AVX2 __m256i min(__m256i a, __m256i b) { return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b)); }
+
+    static SORTING_AVX2 __m256i max(__m256i a, __m256i b) { return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b)); }
+
+    template <bool Strict>
+    static SORTING_AVX2 int greater_mask(__m256i a, __m256i b) {
+        if constexpr (Strict) { return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(a, b))); }
+        else { return ~_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(b, a))) & 0xF; }
+    }
+};
+
+struct Avx2Float {
+    using type = float;
+    static constexpr size_t lanes = 8;
+    static constexpr type max_value = std::numeric_limits<type>::infinity();
+
+    static SORTING_AVX2 __m256i set1(type x) { return _mm256_castps_si256(_mm256_set1_ps(x)); }
+
+    // blends rather than _mm256_min_ps, which would turn a -0.0 and 0.0 pair into two copies of one of them.
+    // min(a, b) and max(a, b) take opposite operands on equal lanes, so together they keep both; callers must
+    // pass the pair in the same order to each
+    static SORTING_AVX2 __m256i min(__m256i a, __m256i b) {
+        __m256 fa = _mm256_castsi256_ps(a);
+        __m256 fb = _mm256_castsi256_ps(b);
+        return _mm256_castps_si256(_mm256_blendv_ps(fb, fa, _mm256_cmp_ps(fa, fb, _CMP_LT_OQ)));
+    }
+
+    static SORTING_AVX2 __m256i max(__m256i a, __m256i b) {
+        __m256 fa = _mm256_castsi256_ps(a);
+        __m256 fb = _mm256_castsi256_ps(b);
+        return _mm256_castps_si256(_mm256_blendv_ps(fa, fb, _mm256_cmp_ps(fa, fb, _CMP_LT_OQ)));
+    }
+
+    template <bool Strict>
+    static SORTING_AVX2 int greater_mask(__m256i a, __m256i b) {
+        return _mm256_movemask_ps(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), Strict ? _CMP_GT_OQ : _CMP_GE_OQ));
+    }
+};
+
+template <typename T> struct Avx2Traits;
+template <> struct Avx2Traits<int32_t> { using type = Avx2Int32; };
+template <> struct Avx2Traits<int64_t> { using type = Avx2Int64; };
+template <> struct Avx2Traits<float> { using type = Avx2Float; };
+
+template <typename T>
+SORTING_AVX2 __m256i simd_load(const T* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+
+template <typename T>
+SORTING_AVX2 void simd_store(T* p, __m256i v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+
+SORTING_AVX2 inline __m256i simd_permute(__m256i v, const int32_t* words) { return _mm256_permutevar8x32_epi32(v, simd_load(words)); }
+
+template <typename Vec>
+SORTING_AVX2 __m256i bitonic_step(__m256i v, const BitonicLayer& layer) {
+    // the lane taking the max sees the pair swapped, so it passes (partner, v) to be given the same operand order
+    __m256i partner = simd_permute(v, layer.partner);
+    return _mm256_blendv_epi8(Vec::min(v, partner), Vec::max(partner, v), simd_load(layer.takes_max));
+}
+
+/**
+ * Sort a block of at most simd_block_size elements in registers: pad it with the largest value to a power-of-two
+ * number of vectors, sort each vector, then merge pairs of sorted runs until one is left. A merge compares
+ * each run against the reverse of the next, which leaves the smaller halves of all pairs as one bitonic
+ * sequence below another; each is then sorted by comparing vectors at halving distances, then within vectors.
+ */
+template <typename Vec>
+SORTING_AVX2 void simd_sort_block(typename Vec::type* array, size_t size) {
+    using T = typename Vec::type;
+    using Tables = SimdTables<Vec::lanes>;
+    const size_t lanes = Vec::lanes;
+
+    size_t vectors = 1;
+    while (vectors * lanes < size) { vectors *= 2; }
+
+    T padded[simd_block_size];
+    std::copy(array, array + size, padded);
+    std::fill(padded + size, padded + vectors * lanes, Vec::max_value);
+
+    __m256i v[simd_block_size / Vec::lanes];
+    for (size_t i = 0; i < vectors; i++) {
+        v[i] = simd_load(padded + i * lanes);
+        for (const BitonicLayer& layer : Tables::sort) { v[i] = bitonic_step<Vec>(v[i], layer); }
+    }
+
+    for (size_t width = 1; width < vectors; width *= 2) {
+        for (__m256i* run = v; run != v + vectors; run += 2 * width) {
+            for (size_t i = 0; i < width; i++) {
+                __m256i a = run[i];
+                __m256i b = simd_permute(run[2 * width - 1 - i], Tables::reverse.data());
+                run[i] = Vec::min(a, b);
+                run[2 * width - 1 - i] = simd_permute(Vec::max(a, b), Tables::reverse.data());
+            }
+
+            for (size_t distance = width / 2; distance > 0; distance /= 2) {
+                for (size_t i = 0; i < 2 * width; i++) {
+                    if ((i & distance) != 0) { continue; }
+                    __m256i a = run[i];
+                    run[i] = Vec::min(a, run[i + distance]);
+                    run[i + distance] = Vec::max(a, run[i + distance]);
+                }
+            }
+
+            for (size_t i = 0; i < 2 * width; i++) {
+                for (const BitonicLayer& layer : Tables::merge) { run[i] = bitonic_step<Vec>(run[i], layer); }
+            }
+        }
+    }
+
+    for (size_t i = 0; i < vectors; i++) { simd_store(padded + i * lanes, v[i]); }
+    std::copy(padded, padded + size, array);
+}
+
+/**
+ * Partition array[0 ... size), size >= 2 * lanes, into the elements not greater than pivot (Strict) or less than
+ * pivot, followed by the rest; returns the size of the first part. Both ends start as free space by holding
+ * their first vector in registers. Each vector read is permuted so its left elements come first, and then
+ * stored whole at the left write position and at the right one; only the elements that belong at each
+ * end are kept, and the next read comes from whichever side has less free space, so a store never
+ * overwrites unread elements. Elements left over from a size that is not a multiple of lanes are placed last.
+ */
+template <typename Vec, bool Strict>
+SORTING_AVX2 size_t simd_partition(typename Vec::type* array, size_t size, typename Vec::type pivot) {
+    using T = typename Vec::type;
+    using Tables = SimdTables<Vec::lanes>;
+    const size_t lanes = Vec::lanes;
+
+    __m256i pivots = Vec::set1(pivot);
+    size_t leftover = size % lanes;
+
+    T* l_store = array + leftover;
+    T* r_store = array + size;
+
+    auto store = [&](__m256i v) SORTING_AVX2 {
+        int mask = Vec::template greater_mask<Strict>(v, pivots);
+        size_t right_count = std::popcount(unsigned(mask));
+        __m256i permuted = simd_permute(v, Tables::compress[mask].data());
+        simd_store(l_store, permuted);
+        simd_store(r_store - lanes, permuted);
+        l_store += lanes - right_count;
+        r_store -= right_count;
+    };
+
+    __m256i first = simd_load(l_store);
+    __m256i last = simd_load(r_store - lanes);
+    T* left = l_store + lanes;
+    T* right = r_store - lanes;
+
+    while (left != right) {
+        __m256i current;
+        if (r_store - right < left - l_store) {
+            right -= lanes;
+            current = simd_load(right);
+        }
+        else {
+            current = simd_load(left);
+            left += lanes;
+        }
+        store(current);
+    }
+    store(first);
+    store(last);
+
+    // array[0 ... leftover) is still unread; swap each that belongs right with the last left element
+    size_t split = l_store - array;
+    for (size_t i = leftover; i-- > 0;) {
+        if (Strict ? pivot < array[i] : !(array[i] < pivot)) { std::swap(array[i], array[--split]); }
+    }
+    return split;
+}
+
+template <typename Vec>
+SORTING_AVX2 void simd_quick_sort(typename Vec::type* array, size_t size, size_t bad_allowed) {
+    using T = typename Vec::type;
+
+    while (size > simd_block_size) {
+        if (bad_allowed == 0) {
+            heap_sort(array, size, std::less<T>());
+            return;
+        }
+
+        choose_pivot(array, size, std::less<T>());
+        T pivot = array[0];
+
+        size_t split = simd_partition<Vec, false>(array, size, pivot);
+        if (split == 0) {
+            // pivot is the smallest element: everything equal to it is in place
+            split = simd_partition<Vec, true>(array, size, pivot);
+            array += split;
+            size -= split;
+            continue;
+        }
+
+        if (std::min(split, size - split) < size / 8) { bad_allowed--; }
+
+        if (split < size - split) {
+            simd_quick_sort<Vec>(array, split, bad_allowed);
+            array += split;
+            size -= split;
+        }
+        else {
+            simd_quick_sort<Vec>(array + split, size - split, bad_allowed);
+            size = split;
+        }
+    }
+    simd_sort_block<Vec>(array, size);
+}
+#endif
+
+/**
+ * Sort array[0 ... size) of int32_t, int64_t or float ascending. NaNs are moved to the end first, since they
+ * do not order against anything.
+ */
+template <typename T>
+requires std::is_same<T, int32_t>::value || std::is_same<T, int64_t>::value || std::is_same<T, float>::value
+void simd_sort(T* array, size_t size) {
+    if constexpr (std::is_floating_point<T>::value) {
+        size_t numbers = 0;
+        for (size_t i = 0; i < size; i++) {
+            if (array[i] == array[i]) { std::swap(array[numbers++], array[i]); }
+        }
+        size = numbers;
+    }
+
+#if defined(SORTING_AVX2)
+    if (cpu_has_avx2()) {
+        simd_quick_sort<typename Avx2Traits<T>::type>(array, size, std::bit_width(size));
+        return;
+    }
+#endif
+    pdq_sort(array, size);
+}
+
 int main() {}
\ No newline at end of file
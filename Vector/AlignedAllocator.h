@@ -0,0 +1,104 @@
+#ifndef ALIGNED_ALLOCATOR_H
+#define ALIGNED_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+/**
+ * @brief Allocator handing out Alignment-aligned storage (64 bytes by default, one cache line / AVX-512 register).
+ *        Requests of at least HugePageThreshold bytes are mapped directly with mmap, aligned to and rounded up to
+ *        2 MiB huge pages, and advised with MADV_HUGEPAGE so that long scans take far fewer TLB misses. When
+ *        Prefault is set the pages are also touched up front, so the faults are paid at allocation instead of
+ *        during the scan.
+ *        On platforms without mmap every request goes through the aligned operator new.
+ */
+template <class T, size_t Alignment = 64, size_t HugePageThreshold = (size_t(1) << 21), bool Prefault = false>
+class AlignedAllocator {
+    static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+    static_assert(Alignment >= alignof(T), "Alignment must satisfy the alignment of T");
+
+    public:
+        using value_type      = T;
+        using size_type       = size_t;
+        using difference_type = ptrdiff_t;
+
+        static constexpr size_type huge_page_size = size_type(1) << 21;
+        static constexpr size_type small_page_size = 4096;
+
+        template <class U>
+        struct rebind { using other = AlignedAllocator<U, Alignment, HugePageThreshold, Prefault>; };
+
+        AlignedAllocator() noexcept = default;
+
+        template <class U>
+        AlignedAllocator(const AlignedAllocator<U, Alignment, HugePageThreshold, Prefault>&) noexcept {}
+
+        [[nodiscard]] T* allocate(size_type count) {
+            size_type bytes = count * sizeof(T);
+
+#if defined(__linux__)
+            if (bytes >= HugePageThreshold) {
+                size_type length = mapping_length(bytes);
+
+                // over-map by one huge page, then unmap the unaligned head and the spare tail, leaving a mapping
+                // that starts on a huge page boundary and covers whole huge pages, all of which THP can back
+                void* memory = mmap(nullptr, length + huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (memory == MAP_FAILED) { throw std::bad_alloc(); }
+
+                uintptr_t start = reinterpret_cast<uintptr_t>(memory);
+                uintptr_t aligned = (start + huge_page_size - 1) & ~uintptr_t(huge_page_size - 1);
+                if (aligned != start) { munmap(memory, aligned - start); }
+                munmap(reinterpret_cast<void*>(aligned + length), start + huge_page_size - aligned);
+
+                char* data = reinterpret_cast<char*>(aligned);
+#if defined(MADV_HUGEPAGE)
+                // advisory only: the mapping is still usable if transparent huge pages are disabled
+                madvise(data, length, MADV_HUGEPAGE);
+#endif
+                if (Prefault) {
+                    // touched after the advice (MAP_POPULATE would fault in small pages before it), one write per
+                    // small page in case huge pages are unavailable
+                    for (size_type offset = 0; offset < length; offset += small_page_size) {
+                        static_cast<volatile char*>(data)[offset] = 0;
+                    }
+                }
+                return reinterpret_cast<T*>(data);
+            }
+#endif
+
+            return static_cast<T*>(::operator new(bytes, std::align_val_t(Alignment)));
+        }
+
+        void deallocate(T* ptr, size_type count) noexcept {
+            if (ptr == nullptr) { return; }
+
+            size_type bytes = count * sizeof(T);
+
+#if defined(__linux__)
+            // the path and the mapping length are pure functions of the size, so they match those in allocate
+            if (bytes >= HugePageThreshold) {
+                munmap(ptr, mapping_length(bytes));
+                return;
+            }
+#endif
+
+            ::operator delete(ptr, std::align_val_t(Alignment));
+        }
+
+    private:
+        // mapped requests are rounded up to whole huge pages
+        static size_type mapping_length(size_type bytes) noexcept { return (bytes + huge_page_size - 1) & ~(huge_page_size - 1); }
+};
+
+template <class T, class U, size_t A, size_t H, bool P>
+bool operator==(const AlignedAllocator<T, A, H, P>&, const AlignedAllocator<U, A, H, P>&) noexcept { return true; }
+
+template <class T, class U, size_t A, size_t H, bool P>
+bool operator!=(const AlignedAllocator<T, A, H, P>&, const AlignedAllocator<U, A, H, P>&) noexcept { return false; }
+
+#endif
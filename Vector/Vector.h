@@ -3,29 +3,61 @@
 
 #include <algorithm> 
 #include <cstddef> 
+#include <memory> 
 #include <stdexcept> 
 #include <type_traits> 
 #include <utility> 
 
-template <class T>
+template <class T, class Allocator = std::allocator<T>>
 class Vector {
     public:
         class iterator;
 
+        using allocator_type = Allocator;
+
     private:
+        using alloc_traits = std::allocator_traits<Allocator>;
+
         T* array;
         size_t _capacity, _size;
+        [[no_unique_address]] Allocator alloc;
+
+        // Every slot up to the capacity holds a live, value-initialized T (as new T[count] {} did),
+        // so elements are assigned into place rather than constructed on push_back/insert.
+        T* allocate_array(size_t count) {
+            if (count == 0) { return nullptr; }
+
+            T* memory = alloc_traits::allocate(alloc, count);
+            size_t i = 0;
+            try {
+                for (; i < count; i++) { alloc_traits::construct(alloc, memory + i); }
+            }
+            catch (...) {
+                while (i > 0) { alloc_traits::destroy(alloc, memory + --i); }
+                alloc_traits::deallocate(alloc, memory, count);
+                throw;
+            }
+            return memory;
+        }
+
+        void deallocate_array(T* memory, size_t count) noexcept {
+            if (memory == nullptr) { return; }
+
+            for (size_t i = 0; i < count; i++) { alloc_traits::destroy(alloc, memory + i); }
+            alloc_traits::deallocate(alloc, memory, count);
+        }
 
         void grow() { 
-            _capacity = (_capacity == 0) ? 1 : 2 * _capacity;
-            T* newArray = new T[_capacity] {};
+            size_t newCapacity = (_capacity == 0) ? 1 : 2 * _capacity;
+            T* newArray = allocate_array(newCapacity);
 
             for (size_t i = 0; i < _size; ++i) { 
                 newArray[i] = std::move(array[i]);
             }
 
-            delete[] array;
+            deallocate_array(array, _capacity);
             array = newArray;
+            _capacity = newCapacity;
         }
 
     public:
@@ -33,21 +65,27 @@ class Vector {
             array = nullptr; 
         }
 
-        Vector(size_t count, const T& value) : _capacity(count), _size(count) { 
-            array = new T[_capacity] {};
+        explicit Vector(const Allocator& allocator) noexcept : _capacity(0), _size(0), alloc(allocator) { 
+            array = nullptr; 
+        }
+
+        Vector(size_t count, const T& value, const Allocator& allocator = Allocator()) : _capacity(count), _size(count), alloc(allocator) { 
+            array = allocate_array(_capacity);
 
             for (size_t i = 0; i < _size; i++) {
                 array[i] = value;
             } 
         }
 
-        explicit Vector(size_t count) : _capacity(count), _size(count) { 
-            array = new T[_capacity] {}; 
+        explicit Vector(size_t count, const Allocator& allocator = Allocator()) : _capacity(count), _size(count), alloc(allocator) { 
+            array = allocate_array(_capacity); 
         }
 
         // Copy constructor
-        Vector(const Vector& other) : _capacity(other.capacity()), _size(other.size()) {
-            array = new T[_capacity] {};
+        Vector(const Vector& other) 
+            : _capacity(other.capacity()), _size(other.size()), 
+              alloc(alloc_traits::select_on_container_copy_construction(other.alloc)) {
+            array = allocate_array(_capacity);
 
             for (size_t i = 0; i < _size; i++) { 
                 array[i] = other.at(i); 
@@ -58,25 +96,33 @@ class Vector {
             std::swap(src._size, dst._size);
             std::swap(src._capacity, dst._capacity);
             std::swap(src.array, dst.array);
+            std::swap(src.alloc, dst.alloc);
         }
 
         // Move constructor
-        Vector(Vector&& other) noexcept : _capacity(0), _size(0), array(nullptr) {
+        Vector(Vector&& other) noexcept : array(nullptr), _capacity(0), _size(0) {
             swap(*this, other);
         }
 
         // Copy assignment operator
         Vector& operator=(const Vector& other) {
             if (this != &other) {
-                delete[] array;
+                // build the copy first, so a throwing allocation or copy leaves this vector unchanged
+                T* newArray = allocate_array(other._capacity);
+                try {
+                    for (size_t i = 0; i < other._size; i++) { 
+                        newArray[i] = other.array[i];
+                    }
+                }
+                catch (...) {
+                    deallocate_array(newArray, other._capacity);
+                    throw;
+                }
+
+                deallocate_array(array, _capacity);
+                array = newArray;
                 _capacity = other._capacity; 
                 _size = other._size;
-
-                array = new T[_capacity] {};
-
-                for (size_t i = 0; i < _size; i++) { 
-                    array[i] = other.at(i);
-                }
             }
             return *this;
         }
@@ -84,7 +130,7 @@ class Vector {
         // Move assignment operator
         Vector& operator=(Vector&& other) noexcept {
             if (this != &other) {
-                delete[] array;
+                deallocate_array(array, _capacity);
                 array = nullptr;
                 _capacity = _size = 0;
                 swap(*this, other);
@@ -94,10 +140,12 @@ class Vector {
 
         // Destructor
         ~Vector() { 
-            delete[] array;
+            deallocate_array(array, _capacity);
             _capacity = _size = 0;
         }
 
+        allocator_type get_allocator() const noexcept { return alloc; }
+
         iterator begin() noexcept { return iterator(array); }
 
         iterator end() noexcept { return iterator(array) + _size; }
@@ -227,6 +275,7 @@ class Vector {
 
     class iterator {
     public:
+        using container_type    = Vector;
         using iterator_category = std::random_access_iterator_tag;
         using value_type        = T;
         using difference_type   = ptrdiff_t;
@@ -281,12 +330,12 @@ class Vector {
 };
 
 
-// This ensures at compile time that the deduced argument _Iterator is a Vector<T>::iterator
+// This ensures at compile time that the deduced argument _Iterator is a Vector<T, Allocator>::iterator
 // There is no way we know of to back-substitute template <typename T> for external functions
-// because it leads to a non-deduced context
+// because it leads to a non-deduced context, so the iterator names its own container instead
 namespace {
     template <typename _Iterator>
-    using is_vector_iterator = std::is_same<typename Vector<typename _Iterator::value_type>::iterator, _Iterator>;
+    using is_vector_iterator = std::is_same<typename _Iterator::container_type::iterator, _Iterator>;
 }
 
 template <typename _Iterator, bool _enable = is_vector_iterator<_Iterator>::value>